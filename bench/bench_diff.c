@@ -0,0 +1,542 @@
+#include <fnmatch.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "narwhal/narwhal.h"
+
+#define BENCH_MIN_DURATION 100.0
+#define BENCH_MAX_ITERATIONS 1000
+#define BENCH_NOISE_FLOOR 1.0
+
+/*
+ * Benchmark cases
+ */
+
+typedef enum
+{
+    BENCH_TARGET_STRINGS,
+    BENCH_TARGET_LINES,
+    BENCH_TARGET_LINES_PATIENCE,
+    BENCH_TARGET_RENDERER
+} BenchTarget;
+
+typedef struct
+{
+    BenchTarget target;
+    size_t size;
+    size_t line_length;
+    double density;
+} BenchCase;
+
+typedef struct
+{
+    double milliseconds;
+    long peak_kilobytes;
+    NarwhalDiffLimit exceeded_limit;
+} BenchMeasurement;
+
+typedef struct
+{
+    char name[128];
+    double milliseconds;
+    long peak_kilobytes;
+    const char *status;
+    const char *path;
+} BenchResult;
+
+static const char *const target_names[] = { "strings", "lines", "lines_patience", "renderer" };
+static const char *const path_names[] = { "full", "size", "edits", "time" };
+
+static const size_t sizes[] = {
+    1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 100 * 1024 * 1024
+};
+static const size_t line_lengths[] = { 16, 80, 1024 };
+static const double densities[] = { 0.0, 0.01, 0.1 };
+
+static void format_size(char *buffer, size_t buffer_size, size_t size)
+{
+    if (size >= 1024 * 1024)
+    {
+        snprintf(buffer, buffer_size, "%zuMB", size / (1024 * 1024));
+    }
+    else
+    {
+        snprintf(buffer, buffer_size, "%zuKB", size / 1024);
+    }
+}
+
+static void format_case_name(char *buffer, size_t buffer_size, const BenchCase *bench_case)
+{
+    char size[32];
+    format_size(size, sizeof(size), bench_case->size);
+
+    char density[32];
+
+    if (bench_case->density == 0.0)
+    {
+        snprintf(density, sizeof(density), "single");
+    }
+    else
+    {
+        snprintf(density, sizeof(density), "%g%%", bench_case->density * 100.0);
+    }
+
+    snprintf(buffer,
+             buffer_size,
+             "%s/%s/%zu/%s",
+             target_names[bench_case->target],
+             size,
+             bench_case->line_length,
+             density);
+}
+
+/*
+ * Input generation
+ */
+
+static uint64_t random_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static char *generate_original(const BenchCase *bench_case)
+{
+    char *original = malloc(bench_case->size + 1);
+
+    for (size_t i = 0; i < bench_case->size; i++)
+    {
+        bool end_of_line = i % (bench_case->line_length + 1) == bench_case->line_length;
+        original[i] = end_of_line ? '\n' : (char)('a' + next_random() % 26);
+    }
+
+    original[bench_case->size] = '\0';
+
+    return original;
+}
+
+static char *generate_modified(const BenchCase *bench_case, const char *original)
+{
+    char *modified = malloc(bench_case->size + 1);
+    memcpy(modified, original, bench_case->size + 1);
+
+    size_t line_count = bench_case->size / (bench_case->line_length + 1) + 1;
+    size_t edits = (size_t)((double)line_count * bench_case->density);
+
+    if (edits == 0)
+    {
+        edits = 1;
+    }
+
+    for (size_t i = 0; i < edits; i++)
+    {
+        size_t position = (size_t)(next_random() % bench_case->size);
+
+        if (modified[position] != '\n')
+        {
+            modified[position] = modified[position] == 'z' ? 'A' : 'Z';
+        }
+    }
+
+    return modified;
+}
+
+/*
+ * Measurement
+ */
+
+static double elapsed_since(struct timeval start_time)
+{
+    struct timeval end_time;
+    gettimeofday(&end_time, NULL);
+
+    return (double)(end_time.tv_sec - start_time.tv_sec) * 1000.0 +
+           (double)(end_time.tv_usec - start_time.tv_usec) / 1000.0;
+}
+
+static long peak_kilobytes(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+static void run_target(const BenchCase *bench_case, const char *original, const char *modified)
+{
+    NarwhalDiff diff = { 0, NULL };
+
+    switch (bench_case->target)
+    {
+        case BENCH_TARGET_STRINGS:
+            diff = narwhal_diff_strings(original, modified);
+            break;
+
+        case BENCH_TARGET_LINES:
+            diff = narwhal_diff_lines(original, modified);
+            break;
+
+        case BENCH_TARGET_LINES_PATIENCE:
+            narwhal_diff_lines_limited(
+                original, modified, NARWHAL_DIFF_ALGORITHM_PATIENCE, NULL, &diff);
+            break;
+
+        case BENCH_TARGET_RENDERER:
+            narwhal_output_diff(stdout, original, modified);
+            fflush(stdout);
+            break;
+    }
+
+    free(diff.chunks);
+}
+
+static BenchMeasurement measure_case(const BenchCase *bench_case)
+{
+    char *original = generate_original(bench_case);
+    char *modified = generate_modified(bench_case, original);
+
+    BenchMeasurement measurement = { 0.0, 0, NARWHAL_DIFF_LIMIT_NONE };
+
+    // The renderer reads the current options, so the limits are disabled explicitly to always
+    // measure the full diff instead of depending on the defaults
+    NarwhalOptions options = _narwhal_default_options;
+    options.diff_limits = (NarwhalDiffLimits){ 0, 0, 0 };
+    _narwhal_current_options = &options;
+
+    if (bench_case->target == BENCH_TARGET_RENDERER)
+    {
+        NarwhalDiff diff = { 0, NULL };
+        measurement.exceeded_limit = narwhal_diff_lines_limited(
+            original, modified, options.diff_algorithm, &options.diff_limits, &diff);
+        free(diff.chunks);
+    }
+
+    long initial_peak = peak_kilobytes();
+    double total = 0.0;
+
+    for (size_t i = 0; i < BENCH_MAX_ITERATIONS && total < BENCH_MIN_DURATION; i++)
+    {
+        struct timeval start_time;
+        gettimeofday(&start_time, NULL);
+
+        run_target(bench_case, original, modified);
+
+        double milliseconds = elapsed_since(start_time);
+        total += milliseconds;
+
+        if (i == 0 || milliseconds < measurement.milliseconds)
+        {
+            measurement.milliseconds = milliseconds;
+        }
+    }
+
+    measurement.peak_kilobytes = peak_kilobytes() - initial_peak;
+
+    free(original);
+    free(modified);
+
+    return measurement;
+}
+
+static void run_case(const BenchCase *bench_case, unsigned int timeout, BenchResult *result)
+{
+    format_case_name(result->name, sizeof(result->name), bench_case);
+    result->milliseconds = 0.0;
+    result->peak_kilobytes = 0;
+    result->status = "error";
+    result->path = "-";
+
+    int result_pipe[2];
+
+    if (pipe(result_pipe) == -1)
+    {
+        return;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+
+    if (pid == -1)
+    {
+        close(result_pipe[0]);
+        close(result_pipe[1]);
+        return;
+    }
+
+    if (pid == 0)
+    {
+        close(result_pipe[0]);
+
+        if (freopen("/dev/null", "w", stdout) == NULL)
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        alarm(timeout);
+
+        BenchMeasurement measurement = measure_case(bench_case);
+        ssize_t written = write(result_pipe[1], &measurement, sizeof(measurement));
+
+        _exit(written == (ssize_t)sizeof(measurement) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(result_pipe[1]);
+
+    BenchMeasurement measurement;
+    ssize_t bytes_read = read(result_pipe[0], &measurement, sizeof(measurement));
+    close(result_pipe[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+    {
+        result->status = "timeout";
+    }
+    else if (bytes_read == (ssize_t)sizeof(measurement))
+    {
+        result->milliseconds = measurement.milliseconds;
+        result->peak_kilobytes = measurement.peak_kilobytes;
+        result->status = "ok";
+
+        if (bench_case->target == BENCH_TARGET_RENDERER)
+        {
+            result->path = path_names[measurement.exceeded_limit];
+        }
+    }
+}
+
+/*
+ * Baseline comparison
+ */
+
+static bool find_baseline(FILE *baseline, const char *name, double *milliseconds, char *status)
+{
+    rewind(baseline);
+
+    char line[256];
+
+    while (fgets(line, sizeof(line), baseline) != NULL)
+    {
+        char baseline_name[128];
+        long peak;
+
+        if (sscanf(line, "%127s %lf %ld %15s", baseline_name, milliseconds, &peak, status) == 4 &&
+            strcmp(baseline_name, name) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool is_regression(const BenchResult *result, FILE *baseline, double tolerance)
+{
+    double baseline_milliseconds;
+    char baseline_status[16];
+
+    if (!find_baseline(baseline, result->name, &baseline_milliseconds, baseline_status))
+    {
+        return false;
+    }
+
+    if (strcmp(result->status, "ok") != 0)
+    {
+        return strcmp(baseline_status, "ok") == 0;
+    }
+
+    if (strcmp(baseline_status, "ok") != 0)
+    {
+        return false;
+    }
+
+    return result->milliseconds > baseline_milliseconds * (1.0 + tolerance / 100.0) &&
+           result->milliseconds - baseline_milliseconds > BENCH_NOISE_FLOOR;
+}
+
+/*
+ * Command-line interface
+ */
+
+static bool parse_size(const char *value, size_t *size)
+{
+    char *end = NULL;
+    unsigned long long number = strtoull(value, &end, 10);
+
+    if (end == value)
+    {
+        return false;
+    }
+
+    if (strcmp(end, "K") == 0 || strcmp(end, "KB") == 0)
+    {
+        number *= 1024;
+    }
+    else if (strcmp(end, "M") == 0 || strcmp(end, "MB") == 0)
+    {
+        number *= 1024 * 1024;
+    }
+    else if (*end != '\0')
+    {
+        return false;
+    }
+
+    *size = (size_t)number;
+    return true;
+}
+
+static void output_usage(const char *program)
+{
+    printf("Usage: %s [options] [pattern...]\n", program);
+    printf("\n");
+    printf("Run the diff benchmarks whose name matches one of the given glob patterns.\n");
+    printf("Names look like target/size/line_length/density. Each line of the output\n");
+    printf("contains the name, the best time in milliseconds, the additional peak\n");
+    printf("memory in kilobytes, the status of a benchmark and the path taken by the\n");
+    printf("renderer (full, or the diff limit that made it print a summary).\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --max-size=SIZE       Skip inputs larger than SIZE (default 1MB)\n");
+    printf("  --timeout=SECONDS     Abort benchmarks after SECONDS (default 10)\n");
+    printf("  --baseline=FILE       Compare the results with a previous output\n");
+    printf("  --tolerance=PERCENT   Allowed slowdown before reporting a regression\n");
+    printf("                        (default 25)\n");
+    printf("  -h, --help            Display this message\n");
+}
+
+static bool matches_patterns(const char *name, int argc, char *argv[], int first_pattern)
+{
+    if (first_pattern >= argc)
+    {
+        return true;
+    }
+
+    for (int i = first_pattern; i < argc; i++)
+    {
+        if (fnmatch(argv[i], name, 0) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_size = 1024 * 1024;
+    unsigned int timeout = 10;
+    const char *baseline_path = NULL;
+    double tolerance = 25.0;
+
+    int first_pattern = 1;
+
+    for (; first_pattern < argc && argv[first_pattern][0] == '-'; first_pattern++)
+    {
+        char *argument = argv[first_pattern];
+
+        if (strncmp(argument, "--max-size=", 11) == 0 && parse_size(argument + 11, &max_size))
+        {
+            continue;
+        }
+        else if (strncmp(argument, "--timeout=", 10) == 0)
+        {
+            timeout = (unsigned int)strtoul(argument + 10, NULL, 10);
+        }
+        else if (strncmp(argument, "--baseline=", 11) == 0)
+        {
+            baseline_path = argument + 11;
+        }
+        else if (strncmp(argument, "--tolerance=", 12) == 0)
+        {
+            tolerance = strtod(argument + 12, NULL);
+        }
+        else if (strcmp(argument, "-h") == 0 || strcmp(argument, "--help") == 0)
+        {
+            output_usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option \"%s\". Run with --help for usage.\n", argument);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *baseline = NULL;
+
+    if (baseline_path != NULL && (baseline = fopen(baseline_path, "r")) == NULL)
+    {
+        fprintf(stderr, "Couldn't open baseline \"%s\".\n", baseline_path);
+        return EXIT_FAILURE;
+    }
+
+    size_t regressions = 0;
+
+    for (size_t t = 0; t < sizeof(target_names) / sizeof(*target_names); t++)
+    {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes) && sizes[s] <= max_size; s++)
+        {
+            for (size_t l = 0; l < sizeof(line_lengths) / sizeof(*line_lengths); l++)
+            {
+                for (size_t d = 0; d < sizeof(densities) / sizeof(*densities); d++)
+                {
+                    BenchCase bench_case = {
+                        (BenchTarget)t, sizes[s], line_lengths[l], densities[d]
+                    };
+                    BenchResult result;
+
+                    format_case_name(result.name, sizeof(result.name), &bench_case);
+
+                    if (!matches_patterns(result.name, argc, argv, first_pattern))
+                    {
+                        continue;
+                    }
+
+                    run_case(&bench_case, timeout, &result);
+
+                    printf("%s\t%.3f\t%ld\t%s\t%s\n",
+                           result.name,
+                           result.milliseconds,
+                           result.peak_kilobytes,
+                           result.status,
+                           result.path);
+                    fflush(stdout);
+
+                    if (baseline != NULL && is_regression(&result, baseline, tolerance))
+                    {
+                        fprintf(stderr, "Regression: %s\n", result.name);
+                        regressions++;
+                    }
+                }
+            }
+        }
+    }
+
+    if (baseline != NULL)
+    {
+        fclose(baseline);
+    }
+
+    if (regressions > 0)
+    {
+        fprintf(stderr, "%zu benchmarks regressed.\n", regressions);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,261 @@
+#include "narwhal/arena/arena.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/*
+ * Allocation header
+ */
+
+typedef struct
+{
+    size_t size;
+    size_t alignment;
+} AllocationHeader;
+
+static void write_header(unsigned char *pointer, size_t size, size_t alignment)
+{
+    AllocationHeader header = { size, alignment };
+    memcpy(pointer - sizeof(AllocationHeader), &header, sizeof(AllocationHeader));
+}
+
+static AllocationHeader read_header(const unsigned char *pointer)
+{
+    AllocationHeader header;
+    memcpy(&header, pointer - sizeof(AllocationHeader), sizeof(AllocationHeader));
+
+    return header;
+}
+
+static uintptr_t align_up(uintptr_t address, size_t alignment)
+{
+    return (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+}
+
+/*
+ * Arena initialization
+ */
+
+static void initialize_arena(NarwhalArena *arena, size_t block_size)
+{
+    arena->block_size = block_size;
+    arena->block = NULL;
+    arena->adopted = NULL;
+}
+
+NarwhalArena *narwhal_new_arena(size_t block_size)
+{
+    NarwhalArena *arena = malloc(sizeof(NarwhalArena));
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    initialize_arena(arena, block_size);
+
+    return arena;
+}
+
+/*
+ * Arena blocks
+ */
+
+static unsigned char *block_data(NarwhalArenaBlock *block)
+{
+    return (unsigned char *)(block + 1);
+}
+
+static NarwhalArenaBlock *push_block(NarwhalArena *arena, size_t minimum_size)
+{
+    size_t size = minimum_size > arena->block_size ? minimum_size : arena->block_size;
+
+    if (size > SIZE_MAX - sizeof(NarwhalArenaBlock))
+    {
+        return NULL;
+    }
+
+    NarwhalArenaBlock *block = malloc(sizeof(NarwhalArenaBlock) + size);
+
+    if (block == NULL)
+    {
+        return NULL;
+    }
+
+    block->previous = arena->block;
+    block->size = size;
+    block->offset = 0;
+
+    arena->block = block;
+
+    return block;
+}
+
+static unsigned char *block_reserve(NarwhalArenaBlock *block, size_t size, size_t alignment)
+{
+    if (block == NULL)
+    {
+        return NULL;
+    }
+
+    uintptr_t base = (uintptr_t)block_data(block);
+    uintptr_t start = align_up(base + block->offset + sizeof(AllocationHeader), alignment);
+
+    if (start < base || start + size > base + block->size || start + size < start)
+    {
+        return NULL;
+    }
+
+    block->offset = (size_t)(start + size - base);
+
+    return (unsigned char *)start;
+}
+
+/*
+ * Arena allocation
+ */
+
+void *narwhal_arena_alloc(NarwhalArena *arena, size_t size, size_t alignment)
+{
+    if ((alignment & (alignment - 1)) != 0)
+    {
+        fprintf(
+            stderr, "Invalid alignment %zu. The alignment must be a power of two.\n", alignment);
+        return NULL;
+    }
+
+    if (alignment < NARWHAL_ARENA_DEFAULT_ALIGNMENT)
+    {
+        alignment = NARWHAL_ARENA_DEFAULT_ALIGNMENT;
+    }
+
+    unsigned char *pointer = block_reserve(arena->block, size, alignment);
+
+    if (pointer == NULL)
+    {
+        if (size > SIZE_MAX - sizeof(AllocationHeader) - alignment)
+        {
+            return NULL;
+        }
+
+        NarwhalArenaBlock *block = push_block(arena, size + sizeof(AllocationHeader) + alignment);
+        pointer = block_reserve(block, size, alignment);
+
+        if (pointer == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    write_header(pointer, size, alignment);
+
+    return pointer;
+}
+
+void *narwhal_arena_realloc(NarwhalArena *arena, void *pointer, size_t size)
+{
+    if (pointer == NULL)
+    {
+        return narwhal_arena_alloc(arena, size, NARWHAL_ARENA_DEFAULT_ALIGNMENT);
+    }
+
+    AllocationHeader header = read_header(pointer);
+
+    NarwhalArenaBlock *block = arena->block;
+    uintptr_t base = (uintptr_t)block_data(block);
+    uintptr_t start = (uintptr_t)pointer;
+
+    if (start + header.size == base + block->offset && start + size <= base + block->size &&
+        start + size >= start)
+    {
+        block->offset = (size_t)(start + size - base);
+        write_header(pointer, size, header.alignment);
+
+        return pointer;
+    }
+
+    void *resized = narwhal_arena_alloc(arena, size, header.alignment);
+
+    if (resized == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(resized, pointer, header.size < size ? header.size : size);
+
+    return resized;
+}
+
+void narwhal_arena_adopt(NarwhalArena *arena, void *pointer)
+{
+    narwhal_arena_adopt_mapping(arena, pointer, 0);
+}
+
+void narwhal_arena_adopt_mapping(NarwhalArena *arena, void *pointer, size_t size)
+{
+    NarwhalArenaAdoption *adoption =
+        narwhal_arena_alloc(arena, sizeof(NarwhalArenaAdoption), _Alignof(NarwhalArenaAdoption));
+
+    if (adoption == NULL)
+    {
+        return;
+    }
+
+    adoption->pointer = pointer;
+    adoption->mapping_size = size;
+    adoption->next = arena->adopted;
+    arena->adopted = adoption;
+}
+
+/*
+ * Reset
+ */
+
+void narwhal_arena_reset(NarwhalArena *arena)
+{
+    for (NarwhalArenaAdoption *adoption = arena->adopted; adoption != NULL;
+         adoption = adoption->next)
+    {
+        if (adoption->mapping_size > 0)
+        {
+            munmap(adoption->pointer, adoption->mapping_size);
+        }
+        else
+        {
+            free(adoption->pointer);
+        }
+    }
+    arena->adopted = NULL;
+
+    while (arena->block != NULL && arena->block->previous != NULL)
+    {
+        NarwhalArenaBlock *previous = arena->block->previous;
+        free(arena->block);
+        arena->block = previous;
+    }
+
+    if (arena->block != NULL && arena->block->size > arena->block_size)
+    {
+        free(arena->block);
+        arena->block = NULL;
+    }
+
+    if (arena->block != NULL)
+    {
+        arena->block->offset = 0;
+    }
+}
+
+/*
+ * Cleanup
+ */
+
+void narwhal_free_arena(NarwhalArena *arena)
+{
+    narwhal_arena_reset(arena);
+    free(arena->block);
+    free(arena);
+}
@@ -0,0 +1,41 @@
+#ifndef NARWHAL_ARENA_H
+#define NARWHAL_ARENA_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "narwhal/types.h"
+
+#define NARWHAL_ARENA_BLOCK_SIZE ((size_t)64 * 1024)
+#define NARWHAL_ARENA_DEFAULT_ALIGNMENT _Alignof(max_align_t)
+
+struct NarwhalArena
+{
+    size_t block_size;
+    NarwhalArenaBlock *block;
+    NarwhalArenaAdoption *adopted;
+};
+
+struct NarwhalArenaBlock
+{
+    NarwhalArenaBlock *previous;
+    size_t size;
+    size_t offset;
+};
+
+struct NarwhalArenaAdoption
+{
+    void *pointer;
+    size_t mapping_size;
+    NarwhalArenaAdoption *next;
+};
+
+NarwhalArena *narwhal_new_arena(size_t block_size);
+void *narwhal_arena_alloc(NarwhalArena *arena, size_t size, size_t alignment);
+void *narwhal_arena_realloc(NarwhalArena *arena, void *pointer, size_t size);
+void narwhal_arena_adopt(NarwhalArena *arena, void *pointer);
+void narwhal_arena_adopt_mapping(NarwhalArena *arena, void *pointer, size_t size);
+void narwhal_arena_reset(NarwhalArena *arena);
+void narwhal_free_arena(NarwhalArena *arena);
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef NARWHAL_ARENA_TYPES_H
+#define NARWHAL_ARENA_TYPES_H
+
+typedef struct NarwhalArena NarwhalArena;
+typedef struct NarwhalArenaBlock NarwhalArenaBlock;
+typedef struct NarwhalArenaAdoption NarwhalArenaAdoption;
+
+#endif
@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "narwhal/hexdump/hexdump.h"
+#include "narwhal/options/options.h"
 #include "narwhal/output/ansi.h"
 #include "narwhal/output/output.h"
 #include "narwhal/result/result.h"
@@ -92,9 +93,14 @@ bool narwhal_check_memory_equal(const void *actual,
     size_t bytes_per_row = narwhal_optimal_bytes_per_row(element_size, 16, 8);
 
     NarwhalTestResult *test_result = _narwhal_current_test->result;
-    test_result->diff_original = narwhal_hexdump(expected, size, bytes_per_row);
+    narwhal_hexdump_mismatches(actual,
+                               expected,
+                               size,
+                               bytes_per_row,
+                               _narwhal_current_options->hexdump_context,
+                               &test_result->diff_modified,
+                               &test_result->diff_original);
     test_result->diff_original_size = strlen(test_result->diff_original) + 1;
-    test_result->diff_modified = narwhal_hexdump(actual, size, bytes_per_row);
     test_result->diff_modified_size = strlen(test_result->diff_modified) + 1;
 
     return false;
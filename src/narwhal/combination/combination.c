@@ -0,0 +1,861 @@
+#include "narwhal/combination/combination.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "narwhal/collection/collection.h"
+#include "narwhal/group/group.h"
+#include "narwhal/options/options.h"
+#include "narwhal/param/param.h"
+#include "narwhal/selector/selector.h"
+#include "narwhal/test/test.h"
+#include "narwhal/unused_attribute.h"
+
+/*
+ * Covering array tuples
+ */
+
+static size_t count_param_subsets(size_t param_count, size_t strength)
+{
+    size_t count = 1;
+
+    for (size_t i = 0; i < strength; i++)
+    {
+        count = count * (param_count - i) / (i + 1);
+    }
+
+    return count;
+}
+
+static bool tuple_is_covered(const NarwhalParamCombinations *combinations, size_t tuple)
+{
+    return (combinations->covered[tuple / 8] >> (tuple % 8)) & 1;
+}
+
+static void cover_tuple(NarwhalParamCombinations *combinations, size_t tuple)
+{
+    if (!tuple_is_covered(combinations, tuple))
+    {
+        combinations->covered[tuple / 8] |= (unsigned char)(1 << (tuple % 8));
+        combinations->uncovered_count--;
+    }
+}
+
+static size_t row_tuple(const NarwhalParamCombinations *combinations, size_t subset)
+{
+    const size_t *members = combinations->subset_members + subset * combinations->strength;
+    size_t index = 0;
+
+    for (size_t i = 0; i < combinations->strength; i++)
+    {
+        index = index * combinations->params[members[i]]->count + combinations->row[members[i]];
+    }
+
+    return combinations->subset_offsets[subset] + index;
+}
+
+static void assign_tuple(NarwhalParamCombinations *combinations, size_t tuple, bool *assigned)
+{
+    size_t subset = 0;
+
+    while (combinations->subset_offsets[subset + 1] <= tuple)
+    {
+        subset++;
+    }
+
+    const size_t *members = combinations->subset_members + subset * combinations->strength;
+    size_t index = tuple - combinations->subset_offsets[subset];
+
+    for (size_t i = combinations->strength; i > 0; i--)
+    {
+        size_t member = members[i - 1];
+        size_t count = combinations->params[member]->count;
+
+        combinations->row[member] = index % count;
+        assigned[member] = true;
+        index /= count;
+    }
+}
+
+static void initialize_covering_array(NarwhalParamCombinations *combinations)
+{
+    size_t param_count = combinations->param_count;
+    size_t strength = combinations->strength;
+    size_t subset_count = count_param_subsets(param_count, strength);
+
+    combinations->subset_count = subset_count;
+    combinations->subset_members = malloc(subset_count * strength * sizeof(size_t));
+    combinations->subset_offsets = malloc((subset_count + 1) * sizeof(size_t));
+
+    size_t members[strength];
+
+    for (size_t i = 0; i < strength; i++)
+    {
+        members[i] = i;
+    }
+
+    size_t offset = 0;
+
+    for (size_t subset = 0; subset < subset_count; subset++)
+    {
+        memcpy(combinations->subset_members + subset * strength,
+               members,
+               strength * sizeof(size_t));
+        combinations->subset_offsets[subset] = offset;
+
+        size_t tuples = 1;
+
+        for (size_t i = 0; i < strength; i++)
+        {
+            tuples *= combinations->params[members[i]]->count;
+        }
+
+        offset += tuples;
+
+        size_t position = strength;
+
+        while (position > 0 && members[position - 1] == param_count - strength + position - 1)
+        {
+            position--;
+        }
+
+        if (position > 0)
+        {
+            members[position - 1]++;
+
+            for (size_t i = position; i < strength; i++)
+            {
+                members[i] = members[i - 1] + 1;
+            }
+        }
+    }
+
+    combinations->subset_offsets[subset_count] = offset;
+    combinations->tuple_count = offset;
+    combinations->uncovered_count = offset;
+    combinations->covered = calloc(offset / 8 + 1, 1);
+}
+
+/*
+ * Random numbers
+ */
+
+static uint64_t mix_seed(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15u;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9u;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebu;
+
+    return value ^ (value >> 31);
+}
+
+static uint64_t hash_string(uint64_t hash, const char *string)
+{
+    for (const char *chr = string; *chr != '\0'; chr++)
+    {
+        hash = (hash ^ (unsigned char)*chr) * 0x100000001b3u;
+    }
+
+    // Separate the strings so that "a" + "bc" and "ab" + "c" don't collide
+    return (hash ^ 0xffu) * 0x100000001b3u;
+}
+
+static uint64_t test_random_state(const NarwhalTest *test)
+{
+    uint64_t hash = 0xcbf29ce484222325u;
+
+    if (test->group != NULL && test->group->full_name != NULL)
+    {
+        hash = hash_string(hash, test->group->full_name);
+    }
+
+    // Only the base name keeps the seed reproducible across checkouts
+    const char *basename = strrchr(test->filename, '/');
+    hash = hash_string(hash, basename != NULL ? basename + 1 : test->filename);
+    hash = hash_string(hash, test->name);
+
+    uint64_t state = mix_seed(hash ^ mix_seed(_narwhal_current_options->seed));
+
+    return state != 0 ? state : 1;
+}
+
+static size_t random_value(NarwhalParamCombinations *combinations, size_t count)
+{
+    uint64_t state = combinations->random_state;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    combinations->random_state = state;
+
+    return (size_t)(state % count);
+}
+
+/*
+ * Sampling
+ */
+
+static size_t greatest_common_divisor(size_t a, size_t b)
+{
+    while (b != 0)
+    {
+        size_t remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+static void initialize_sampling(NarwhalParamCombinations *combinations)
+{
+    size_t space = 1;
+
+    for (size_t i = 0; i < combinations->param_count; i++)
+    {
+        size_t count = combinations->params[i]->count;
+
+        if (count > 0 && space > SIZE_MAX / count)
+        {
+            return;
+        }
+
+        space *= count;
+    }
+
+    if (space == 0)
+    {
+        return;
+    }
+
+    size_t stride = random_value(combinations, space);
+
+    while (greatest_common_divisor(stride, space) != 1)
+    {
+        stride = stride + 1 < space ? stride + 1 : 1;
+    }
+
+    combinations->sample_permutation = true;
+    combinations->sample_space = space;
+    combinations->sample_position = random_value(combinations, space);
+    combinations->sample_stride = stride;
+    combinations->sample_remaining = space;
+}
+
+static void assign_sample_position(NarwhalParamCombinations *combinations)
+{
+    size_t position = combinations->sample_position;
+
+    for (size_t i = combinations->param_count; i > 0; i--)
+    {
+        size_t count = combinations->params[i - 1]->count;
+
+        combinations->row[i - 1] = position % count;
+        position /= count;
+    }
+
+    size_t space = combinations->sample_space;
+    size_t stride = combinations->sample_stride;
+
+    combinations->sample_position = combinations->sample_position >= space - stride
+                                        ? combinations->sample_position - (space - stride)
+                                        : combinations->sample_position + stride;
+    combinations->sample_remaining--;
+}
+
+/*
+ * Parameter selections
+ */
+
+static void collect_pin_sets(NarwhalParamCombinations *combinations)
+{
+    const NarwhalCollection *selectors = _narwhal_current_options->selectors;
+
+    if (selectors == NULL)
+    {
+        return;
+    }
+
+    bool unpinned = false;
+
+    NarwhalTestSelector *selector;
+    NARWHAL_EACH(selector, selectors)
+    {
+        if (!narwhal_test_selector_selects_test(selector, combinations->test))
+        {
+            continue;
+        }
+
+        if (selector->param_selections->count == 0)
+        {
+            unpinned = true;
+            break;
+        }
+
+        narwhal_collection_append(combinations->pin_sets, selector->param_selections);
+    }
+
+    if (unpinned)
+    {
+        while (combinations->pin_sets->count > 0)
+        {
+            narwhal_collection_pop(combinations->pin_sets);
+        }
+    }
+
+    combinations->current_pin_set = combinations->pin_sets->first;
+}
+
+static size_t find_selected_param(const NarwhalParamCombinations *combinations,
+                                  const NarwhalParamSelection *param_selection)
+{
+    for (size_t i = 0; i < combinations->param_count; i++)
+    {
+        if (strcmp(combinations->params[i]->name, param_selection->name) == 0)
+        {
+            return param_selection->index < combinations->params[i]->count
+                       ? i
+                       : combinations->param_count;
+        }
+    }
+
+    return combinations->param_count;
+}
+
+static bool pin_params(NarwhalParamCombinations *combinations,
+                       const NarwhalCollection *param_selections)
+{
+    for (size_t i = 0; i < combinations->param_count; i++)
+    {
+        combinations->pinned[i] = SIZE_MAX;
+        combinations->row[i] = 0;
+    }
+
+    NarwhalParamSelection *param_selection;
+    NARWHAL_EACH(param_selection, param_selections)
+    {
+        size_t i = find_selected_param(combinations, param_selection);
+
+        if (i == combinations->param_count ||
+            (combinations->pinned[i] != SIZE_MAX &&
+             combinations->pinned[i] != param_selection->index))
+        {
+            return false;
+        }
+
+        combinations->pinned[i] = param_selection->index;
+        combinations->row[i] = param_selection->index;
+    }
+
+    return true;
+}
+
+static bool pin_set_selects_row(const NarwhalParamCombinations *combinations,
+                                const NarwhalCollection *param_selections)
+{
+    NarwhalParamSelection *param_selection;
+    NARWHAL_EACH(param_selection, param_selections)
+    {
+        size_t i = find_selected_param(combinations, param_selection);
+
+        if (i == combinations->param_count || combinations->row[i] != param_selection->index)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool row_selected_by_previous_pin_set(const NarwhalParamCombinations *combinations)
+{
+    // Overlapping selectors would otherwise run the rows they share once per selector
+    for (NarwhalCollectionItem *pin_set = combinations->pin_sets->first;
+         pin_set != combinations->current_pin_set;
+         pin_set = pin_set->next)
+    {
+        if (pin_set_selects_row(combinations, pin_set->value))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Combinations initialization
+ */
+
+static void initialize_param_combinations(NarwhalParamCombinations *combinations,
+                                          NarwhalTest *test)
+{
+    combinations->test = test;
+    combinations->param_count = test->params->count;
+    combinations->params = malloc((combinations->param_count + 1) * sizeof(NarwhalTestParam *));
+    combinations->row = calloc(combinations->param_count + 1, sizeof(size_t));
+    combinations->pinned = malloc((combinations->param_count + 1) * sizeof(size_t));
+    combinations->pin_sets = narwhal_empty_collection();
+    combinations->current_pin_set = NULL;
+    combinations->started = false;
+    combinations->exhausted = false;
+    combinations->sampled = test->sample_count > 0 || test->sample_budget > 0;
+    combinations->limit = test->sample_count;
+    combinations->produced = 0;
+    combinations->budget = test->sample_budget;
+    combinations->sample_permutation = false;
+    combinations->sample_space = 0;
+    combinations->sample_position = 0;
+    combinations->sample_stride = 0;
+    combinations->sample_remaining = 0;
+    combinations->strength = 0;
+    combinations->subset_count = 0;
+    combinations->subset_members = NULL;
+    combinations->subset_offsets = NULL;
+    combinations->tuple_count = 0;
+    combinations->uncovered_count = 0;
+    combinations->cursor = 0;
+    combinations->covered = NULL;
+    combinations->random_state = test_random_state(test);
+
+    size_t index = 0;
+
+    NarwhalTestParam *test_param;
+    NARWHAL_EACH(test_param, test->params)
+    {
+        combinations->pinned[index] = SIZE_MAX;
+        combinations->params[index++] = test_param;
+
+        if (test_param->count == 0)
+        {
+            combinations->exhausted = true;
+        }
+    }
+
+    collect_pin_sets(combinations);
+
+    if (combinations->current_pin_set != NULL)
+    {
+        combinations->sampled = false;
+        combinations->limit = 0;
+        combinations->budget = 0;
+    }
+    else if (test->combination_strength > 0 &&
+             test->combination_strength < combinations->param_count)
+    {
+        combinations->strength = test->combination_strength;
+        initialize_covering_array(combinations);
+    }
+    else if (combinations->sampled && !combinations->exhausted)
+    {
+        initialize_sampling(combinations);
+    }
+}
+
+NarwhalParamCombinations *narwhal_new_param_combinations(NarwhalTest *test)
+{
+    NarwhalParamCombinations *combinations = malloc(sizeof(NarwhalParamCombinations));
+    initialize_param_combinations(combinations, test);
+
+    return combinations;
+}
+
+/*
+ * Constraints
+ */
+
+bool narwhal_param_combination_allowed(NarwhalTest *test)
+{
+    if (test->constraints->count == 0)
+    {
+        return true;
+    }
+
+    // Constraints can't read the value of a param that failed to load
+    NarwhalTestParam *test_param;
+    NARWHAL_EACH(test_param, test->params)
+    {
+        if (test_param->error != NULL)
+        {
+            return true;
+        }
+    }
+
+    NarwhalCollection *previous_params = _narwhal_current_params;
+    _narwhal_current_params = test->accessible_params;
+
+    bool allowed = true;
+
+    NarwhalConstraintModifierArgs *constraint;
+    NARWHAL_EACH(constraint, test->constraints)
+    {
+        constraint->predicate(&allowed);
+
+        if (!allowed)
+        {
+            break;
+        }
+    }
+
+    _narwhal_current_params = previous_params;
+
+    return allowed;
+}
+
+static bool apply_row(NarwhalParamCombinations *combinations)
+{
+    for (size_t i = 0; i < combinations->param_count; i++)
+    {
+        combinations->params[i]->index = combinations->row[i];
+    }
+
+    return narwhal_param_combination_allowed(combinations->test);
+}
+
+/*
+ * Full cartesian product
+ */
+
+static bool advance_product_row(NarwhalParamCombinations *combinations)
+{
+    for (size_t i = combinations->param_count; i > 0; i--)
+    {
+        if (combinations->pinned[i - 1] != SIZE_MAX)
+        {
+            continue;
+        }
+
+        if (++combinations->row[i - 1] < combinations->params[i - 1]->count)
+        {
+            return true;
+        }
+
+        combinations->row[i - 1] = 0;
+    }
+
+    return false;
+}
+
+static bool next_product_row(NarwhalParamCombinations *combinations)
+{
+    bool available = !combinations->started || advance_product_row(combinations);
+    combinations->started = true;
+
+    while (available)
+    {
+        if (apply_row(combinations))
+        {
+            return true;
+        }
+
+        available = advance_product_row(combinations);
+    }
+
+    return false;
+}
+
+static bool next_pinned_row(NarwhalParamCombinations *combinations)
+{
+    while (combinations->current_pin_set != NULL)
+    {
+        bool available = combinations->started ? advance_product_row(combinations)
+                                                : pin_params(combinations,
+                                                             combinations->current_pin_set->value);
+        combinations->started = true;
+
+        while (available)
+        {
+            if (!row_selected_by_previous_pin_set(combinations) && apply_row(combinations))
+            {
+                return true;
+            }
+
+            available = advance_product_row(combinations);
+        }
+
+        combinations->current_pin_set = combinations->current_pin_set->next;
+        combinations->started = false;
+    }
+
+    return false;
+}
+
+/*
+ * Sampled rows
+ */
+
+static bool next_sampled_row(NarwhalParamCombinations *combinations)
+{
+    if (combinations->sample_permutation)
+    {
+        while (combinations->sample_remaining > 0)
+        {
+            assign_sample_position(combinations);
+
+            if (apply_row(combinations))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    for (size_t attempt = 0; attempt < NARWHAL_COMBINATION_ATTEMPTS; attempt++)
+    {
+        for (size_t i = 0; i < combinations->param_count; i++)
+        {
+            combinations->row[i] = random_value(combinations, combinations->params[i]->count);
+        }
+
+        if (apply_row(combinations))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Covering array rows
+ */
+
+static size_t count_new_tuples(const NarwhalParamCombinations *combinations,
+                               const bool *assigned,
+                               size_t param)
+{
+    size_t count = 0;
+
+    for (size_t subset = 0; subset < combinations->subset_count; subset++)
+    {
+        const size_t *members = combinations->subset_members + subset * combinations->strength;
+        bool contains_param = false;
+        bool complete = true;
+
+        for (size_t i = 0; i < combinations->strength; i++)
+        {
+            contains_param = contains_param || members[i] == param;
+            complete = complete && (members[i] == param || assigned[members[i]]);
+        }
+
+        if (contains_param && complete &&
+            !tuple_is_covered(combinations, row_tuple(combinations, subset)))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void fill_row(NarwhalParamCombinations *combinations, bool *assigned, bool greedy)
+{
+    for (size_t param = 0; param < combinations->param_count; param++)
+    {
+        if (assigned[param])
+        {
+            continue;
+        }
+
+        size_t count = combinations->params[param]->count;
+
+        if (!greedy)
+        {
+            combinations->row[param] = random_value(combinations, count);
+            assigned[param] = true;
+            continue;
+        }
+
+        size_t best_value = 0;
+        size_t best_count = 0;
+
+        for (size_t value = 0; value < count; value++)
+        {
+            combinations->row[param] = value;
+            size_t new_tuples = count_new_tuples(combinations, assigned, param);
+
+            if (new_tuples > best_count)
+            {
+                best_value = value;
+                best_count = new_tuples;
+            }
+        }
+
+        combinations->row[param] = best_value;
+        assigned[param] = true;
+    }
+}
+
+static bool next_covering_row(NarwhalParamCombinations *combinations)
+{
+    size_t param_count = combinations->param_count;
+
+    while (combinations->uncovered_count > 0)
+    {
+        while (tuple_is_covered(combinations, combinations->cursor))
+        {
+            combinations->cursor++;
+        }
+
+        bool seed[param_count];
+        memset(seed, 0, sizeof(seed));
+        assign_tuple(combinations, combinations->cursor, seed);
+
+        for (size_t attempt = 0; attempt < NARWHAL_COMBINATION_ATTEMPTS; attempt++)
+        {
+            bool assigned[param_count];
+            memcpy(assigned, seed, sizeof(assigned));
+
+            fill_row(combinations, assigned, attempt == 0);
+
+            if (apply_row(combinations))
+            {
+                for (size_t subset = 0; subset < combinations->subset_count; subset++)
+                {
+                    cover_tuple(combinations, row_tuple(combinations, subset));
+                }
+
+                return true;
+            }
+        }
+
+        cover_tuple(combinations, combinations->cursor);
+    }
+
+    return false;
+}
+
+/*
+ * Iterate over combinations
+ */
+
+static bool budget_spent(NarwhalParamCombinations *combinations)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    if (combinations->produced == 0)
+    {
+        time_t budget = combinations->budget;
+
+        combinations->deadline.tv_sec = now.tv_sec + budget / 1000;
+        combinations->deadline.tv_usec = now.tv_usec + (suseconds_t)(budget % 1000) * 1000;
+
+        if (combinations->deadline.tv_usec >= 1000000)
+        {
+            combinations->deadline.tv_sec++;
+            combinations->deadline.tv_usec -= 1000000;
+        }
+
+        return false;
+    }
+
+    return now.tv_sec > combinations->deadline.tv_sec ||
+           (now.tv_sec == combinations->deadline.tv_sec &&
+            now.tv_usec >= combinations->deadline.tv_usec);
+}
+
+bool narwhal_param_combinations_next(NarwhalParamCombinations *combinations)
+{
+    if (combinations->exhausted)
+    {
+        return false;
+    }
+
+    if ((combinations->limit > 0 && combinations->produced >= combinations->limit) ||
+        (combinations->budget > 0 && budget_spent(combinations)))
+    {
+        combinations->exhausted = true;
+        return false;
+    }
+
+    bool found;
+
+    if (combinations->current_pin_set != NULL)
+    {
+        found = next_pinned_row(combinations);
+    }
+    else if (combinations->strength > 0)
+    {
+        found = next_covering_row(combinations);
+    }
+    else if (combinations->sampled)
+    {
+        found = next_sampled_row(combinations);
+    }
+    else
+    {
+        found = next_product_row(combinations);
+    }
+
+    combinations->exhausted = !found;
+    combinations->produced++;
+
+    return found;
+}
+
+/*
+ * Combination modifiers
+ */
+
+void narwhal_combinations_registration_function(NarwhalTest *test,
+                                                _NARWHAL_UNUSED NarwhalCollection *params,
+                                                _NARWHAL_UNUSED NarwhalCollection *fixtures,
+                                                void *args)
+{
+    NarwhalCombinationsModifierArgs *combinations = args;
+
+    test->combination_strength = combinations->strength;
+}
+
+void narwhal_constraint_registration_function(NarwhalTest *test,
+                                              _NARWHAL_UNUSED NarwhalCollection *params,
+                                              _NARWHAL_UNUSED NarwhalCollection *fixtures,
+                                              void *args)
+{
+    narwhal_collection_append(test->constraints, args);
+}
+
+void narwhal_sample_registration_function(NarwhalTest *test,
+                                          _NARWHAL_UNUSED NarwhalCollection *params,
+                                          _NARWHAL_UNUSED NarwhalCollection *fixtures,
+                                          void *args)
+{
+    NarwhalSampleModifierArgs *sample = args;
+
+    if (sample->count > 0)
+    {
+        test->sample_count = sample->count;
+    }
+
+    if (sample->milliseconds > 0)
+    {
+        test->sample_budget = sample->milliseconds;
+    }
+}
+
+/*
+ * Cleanup
+ */
+
+void narwhal_free_param_combinations(NarwhalParamCombinations *combinations)
+{
+    free(combinations->params);
+    free(combinations->row);
+    free(combinations->pinned);
+
+    while (combinations->pin_sets->count > 0)
+    {
+        narwhal_collection_pop(combinations->pin_sets);
+    }
+    narwhal_free_collection(combinations->pin_sets);
+    free(combinations->subset_members);
+    free(combinations->subset_offsets);
+    free(combinations->covered);
+    free(combinations);
+}
@@ -0,0 +1,135 @@
+#ifndef NARWHAL_COMBINATION_H
+#define NARWHAL_COMBINATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "narwhal/types.h"
+#include "narwhal/unused_attribute.h"
+
+#define NARWHAL_COMBINATION_ATTEMPTS 64
+
+struct NarwhalParamCombinations
+{
+    NarwhalTest *test;
+    size_t param_count;
+    NarwhalTestParam **params;
+    size_t *row;
+    size_t *pinned;
+    NarwhalCollection *pin_sets;
+    NarwhalCollectionItem *current_pin_set;
+    bool started;
+    bool exhausted;
+    bool sampled;
+    size_t limit;
+    size_t produced;
+    time_t budget;
+    struct timeval deadline;
+    bool sample_permutation;
+    size_t sample_space;
+    size_t sample_position;
+    size_t sample_stride;
+    size_t sample_remaining;
+    size_t strength;
+    size_t subset_count;
+    size_t *subset_members;
+    size_t *subset_offsets;
+    size_t tuple_count;
+    size_t uncovered_count;
+    size_t cursor;
+    unsigned char *covered;
+    uint64_t random_state;
+};
+
+NarwhalParamCombinations *narwhal_new_param_combinations(NarwhalTest *test);
+bool narwhal_param_combinations_next(NarwhalParamCombinations *combinations);
+bool narwhal_param_combination_allowed(NarwhalTest *test);
+void narwhal_free_param_combinations(NarwhalParamCombinations *combinations);
+
+struct NarwhalCombinationsModifierArgs
+{
+    size_t strength;
+};
+
+struct NarwhalConstraintModifierArgs
+{
+    NarwhalTestConstraint predicate;
+};
+
+struct NarwhalSampleModifierArgs
+{
+    size_t count;
+    time_t milliseconds;
+};
+
+void narwhal_combinations_registration_function(NarwhalTest *test,
+                                                NarwhalCollection *params,
+                                                NarwhalCollection *fixtures,
+                                                void *args);
+void narwhal_constraint_registration_function(NarwhalTest *test,
+                                              NarwhalCollection *params,
+                                              NarwhalCollection *fixtures,
+                                              void *args);
+void narwhal_sample_registration_function(NarwhalTest *test,
+                                          NarwhalCollection *params,
+                                          NarwhalCollection *fixtures,
+                                          void *args);
+
+#define N_WISE(strength)                                                                 \
+    {                                                                                    \
+        narwhal_combinations_registration_function, (NarwhalCombinationsModifierArgs[]) \
+        {                                                                                \
+            {                                                                            \
+                strength                                                                 \
+            }                                                                            \
+        }                                                                                \
+    }
+
+#define PAIRWISE N_WISE(2)
+
+#define SAMPLE(milliseconds)                                                 \
+    {                                                                        \
+        narwhal_sample_registration_function, (NarwhalSampleModifierArgs[]) \
+        {                                                                    \
+            {                                                                \
+                0, milliseconds                                              \
+            }                                                                \
+        }                                                                    \
+    }
+
+#define SAMPLE_COUNT(count)                                                  \
+    {                                                                        \
+        narwhal_sample_registration_function, (NarwhalSampleModifierArgs[]) \
+        {                                                                    \
+            {                                                                \
+                count, 0                                                     \
+            }                                                                \
+        }                                                                    \
+    }
+
+#define DECLARE_CONSTRAINT(constraint_name)                \
+    extern NarwhalTestModifierRegistration constraint_name
+
+#define TEST_CONSTRAINT(constraint_name)                                                      \
+    DECLARE_CONSTRAINT(constraint_name);                                                      \
+    static void _narwhal_constraint_##constraint_name(bool *_narwhal_combination_allowed);    \
+    static NarwhalConstraintModifierArgs _narwhal_constraint_args_##constraint_name = {       \
+        _narwhal_constraint_##constraint_name                                                 \
+    };                                                                                        \
+    NarwhalTestModifierRegistration constraint_name = {                                       \
+        narwhal_constraint_registration_function, &_narwhal_constraint_args_##constraint_name \
+    };                                                                                        \
+    static void _narwhal_constraint_##constraint_name(                                        \
+        _NARWHAL_UNUSED bool *_narwhal_combination_allowed)
+
+#define REJECT_COMBINATION()                   \
+    do                                         \
+    {                                          \
+        *_narwhal_combination_allowed = false; \
+        return;                                \
+    } while (0)
+
+#endif
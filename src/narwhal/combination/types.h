@@ -0,0 +1,14 @@
+#ifndef NARWHAL_COMBINATION_TYPES_H
+#define NARWHAL_COMBINATION_TYPES_H
+
+#include <stdbool.h>
+
+typedef struct NarwhalParamCombinations NarwhalParamCombinations;
+
+typedef void (*NarwhalTestConstraint)(bool *allowed);
+
+typedef struct NarwhalCombinationsModifierArgs NarwhalCombinationsModifierArgs;
+typedef struct NarwhalConstraintModifierArgs NarwhalConstraintModifierArgs;
+typedef struct NarwhalSampleModifierArgs NarwhalSampleModifierArgs;
+
+#endif
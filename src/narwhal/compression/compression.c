@@ -0,0 +1,224 @@
+#include "narwhal/compression/compression.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "narwhal/utils.h"
+
+/*
+ * The format is a sequence of LZ77 blocks similar to LZ4. Each block starts with a token whose
+ * high nibble is the number of literals and whose low nibble is the match length minus the
+ * minimum match. A nibble of 15 is followed by extra bytes that are added to the length until
+ * one of them is lower than 255. The literals come next, followed by the 2-byte little-endian
+ * offset of the match. The last block only contains literals.
+ */
+
+#define COMPRESSION_MIN_MATCH 4
+#define COMPRESSION_MAX_OFFSET 65535
+#define COMPRESSION_HASH_BITS 14
+#define COMPRESSION_SKIP_SHIFT 6
+
+static uint32_t compression_read32(const char *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static uint32_t compression_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - COMPRESSION_HASH_BITS);
+}
+
+static char *compression_write_length(char *output, size_t length)
+{
+    while (length >= 255)
+    {
+        *output++ = (char)255;
+        length -= 255;
+    }
+
+    *output++ = (char)length;
+
+    return output;
+}
+
+static char *compression_write_block(char *output,
+                                     const char *literals,
+                                     size_t literal_count,
+                                     size_t offset,
+                                     size_t match_length)
+{
+    char *token = output++;
+
+    size_t literal_nibble = literal_count < 15 ? literal_count : 15;
+    size_t match_nibble = 0;
+
+    if (literal_count >= 15)
+    {
+        output = compression_write_length(output, literal_count - 15);
+    }
+
+    memcpy(output, literals, literal_count);
+    output += literal_count;
+
+    if (match_length > 0)
+    {
+        size_t extra_length = match_length - COMPRESSION_MIN_MATCH;
+        match_nibble = extra_length < 15 ? extra_length : 15;
+
+        *output++ = (char)(offset & 0xff);
+        *output++ = (char)(offset >> 8);
+
+        if (extra_length >= 15)
+        {
+            output = compression_write_length(output, extra_length - 15);
+        }
+    }
+
+    *token = (char)((literal_nibble << 4) | match_nibble);
+
+    return output;
+}
+
+size_t narwhal_compress_bound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t narwhal_compress(const char *input, size_t size, char *output)
+{
+    uint32_t *table = calloc((size_t)1 << COMPRESSION_HASH_BITS, sizeof(uint32_t));
+
+    char *output_start = output;
+    size_t anchor = 0;
+    size_t index = 0;
+
+    while (index + COMPRESSION_MIN_MATCH <= size)
+    {
+        uint32_t sequence = compression_read32(input + index);
+        uint32_t hash = compression_hash(sequence);
+        size_t candidate = table[hash];
+        table[hash] = (uint32_t)(index + 1);
+
+        if (candidate == 0 || index - (candidate - 1) > COMPRESSION_MAX_OFFSET ||
+            compression_read32(input + candidate - 1) != sequence)
+        {
+            index += 1 + ((index - anchor) >> COMPRESSION_SKIP_SHIFT);
+            continue;
+        }
+
+        size_t match = candidate - 1;
+        size_t match_length =
+            COMPRESSION_MIN_MATCH +
+            narwhal_common_prefix_length(input + index + COMPRESSION_MIN_MATCH,
+                                         input + match + COMPRESSION_MIN_MATCH,
+                                         size - index - COMPRESSION_MIN_MATCH);
+
+        output = compression_write_block(
+            output, input + anchor, index - anchor, index - match, match_length);
+
+        index += match_length;
+        anchor = index;
+    }
+
+    output = compression_write_block(output, input + anchor, size - anchor, 0, 0);
+
+    free(table);
+
+    return (size_t)(output - output_start);
+}
+
+static bool compression_read_length(const unsigned char **input,
+                                    const unsigned char *input_end,
+                                    size_t *length)
+{
+    unsigned char byte;
+
+    do
+    {
+        if (*input >= input_end)
+        {
+            return false;
+        }
+
+        byte = *(*input)++;
+        *length += byte;
+    } while (byte == 255);
+
+    return true;
+}
+
+bool narwhal_decompress(const char *input, size_t compressed_size, char *output, size_t size)
+{
+    const unsigned char *current = (const unsigned char *)input;
+    const unsigned char *input_end = current + compressed_size;
+    size_t position = 0;
+
+    while (current < input_end)
+    {
+        unsigned char token = *current++;
+        size_t literal_count = token >> 4;
+
+        if (literal_count == 15 && !compression_read_length(&current, input_end, &literal_count))
+        {
+            return false;
+        }
+
+        if (literal_count > (size_t)(input_end - current) || literal_count > size - position)
+        {
+            return false;
+        }
+
+        memcpy(output + position, current, literal_count);
+        current += literal_count;
+        position += literal_count;
+
+        if (current == input_end)
+        {
+            break;
+        }
+
+        if (input_end - current < 2)
+        {
+            return false;
+        }
+
+        size_t offset = (size_t)current[0] | ((size_t)current[1] << 8);
+        current += 2;
+
+        size_t match_length = token & 0xf;
+
+        if (match_length == 15 && !compression_read_length(&current, input_end, &match_length))
+        {
+            return false;
+        }
+
+        match_length += COMPRESSION_MIN_MATCH;
+
+        if (offset == 0 || offset > position || match_length > size - position)
+        {
+            return false;
+        }
+
+        const char *match = output + position - offset;
+
+        if (offset >= match_length)
+        {
+            memcpy(output + position, match, match_length);
+        }
+        else
+        {
+            for (size_t i = 0; i < match_length; i++)
+            {
+                output[position + i] = match[i];
+            }
+        }
+
+        position += match_length;
+    }
+
+    return position == size;
+}
@@ -0,0 +1,13 @@
+#ifndef NARWHAL_COMPRESSION_H
+#define NARWHAL_COMPRESSION_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define NARWHAL_COMPRESSION_MIN_SIZE 256
+
+size_t narwhal_compress_bound(size_t size);
+size_t narwhal_compress(const char *input, size_t size, char *output);
+bool narwhal_decompress(const char *input, size_t compressed_size, char *output, size_t size);
+
+#endif
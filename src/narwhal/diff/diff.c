@@ -1,8 +1,13 @@
 #include "narwhal/diff/diff.h"
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include <sys/types.h>
+#include <time.h>
 
 #include "narwhal/utils.h"
 
@@ -249,23 +254,1177 @@ void narwhal_diff_matrix_set(const NarwhalDiffMatrix *diff_matrix,
     diff_matrix->content[narwhal_diff_matrix_index(diff_matrix, row, column)] = value;
 }
 
+/*
+ * Myers diff
+ */
+
+typedef struct
+{
+    const char *original;
+    const char *modified;
+    const size_t *original_ids;
+    const size_t *modified_ids;
+    size_t id_count;
+} DiffSequences;
+
+typedef struct
+{
+    size_t *original_counts;
+    size_t *modified_counts;
+    size_t *modified_positions;
+} DiffPatience;
+
+typedef struct
+{
+    uint16_t slots[256];
+    size_t slot_count;
+    uint64_t *masks;
+    uint64_t *row;
+} DiffBitParallel;
+
+typedef struct
+{
+    size_t capacity;
+    size_t *slots;
+    size_t count;
+    const char **lines;
+    size_t *lengths;
+    uint64_t *hashes;
+} DiffLineTable;
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    NarwhalDiffChunk *chunks;
+    size_t edits;
+    size_t max_edits;
+    bool has_deadline;
+    struct timeval deadline;
+    NarwhalDiffLimit exceeded_limit;
+} DiffScript;
+
+static bool diff_elements_equal(const DiffSequences *sequences,
+                                size_t original_index,
+                                size_t modified_index)
+{
+    if (sequences->original_ids == NULL)
+    {
+        return sequences->original[original_index] == sequences->modified[modified_index];
+    }
+
+    return sequences->original_ids[original_index] == sequences->modified_ids[modified_index];
+}
+
+static void diff_script_append(DiffScript *diff_script,
+                               NarwhalDiffChunkType type,
+                               size_t original_start,
+                               size_t original_end,
+                               size_t modified_start,
+                               size_t modified_end)
+{
+    if (original_start == original_end && modified_start == modified_end)
+    {
+        return;
+    }
+
+    if (type != NARWHAL_DIFF_CHUNK_TYPE_MATCHED)
+    {
+        diff_script->edits += original_end - original_start + modified_end - modified_start;
+    }
+
+    if (diff_script->size > 0)
+    {
+        NarwhalDiffChunk *previous_chunk = &diff_script->chunks[diff_script->size - 1];
+
+        bool both_matched = type == NARWHAL_DIFF_CHUNK_TYPE_MATCHED &&
+                            previous_chunk->type == NARWHAL_DIFF_CHUNK_TYPE_MATCHED;
+        bool both_edited = type != NARWHAL_DIFF_CHUNK_TYPE_MATCHED &&
+                           previous_chunk->type != NARWHAL_DIFF_CHUNK_TYPE_MATCHED;
+
+        if (both_matched || both_edited)
+        {
+            previous_chunk->original_end = original_end;
+            previous_chunk->modified_end = modified_end;
+
+            if (both_edited && previous_chunk->type != type)
+            {
+                previous_chunk->type = NARWHAL_DIFF_CHUNK_TYPE_REPLACED;
+            }
+
+            return;
+        }
+    }
+
+    if (diff_script->size == diff_script->capacity)
+    {
+        diff_script->capacity *= 2;
+        diff_script->chunks =
+            realloc(diff_script->chunks, diff_script->capacity * sizeof(NarwhalDiffChunk));
+    }
+
+    NarwhalDiffChunk *chunk = &diff_script->chunks[diff_script->size];
+    diff_script->size++;
+
+    chunk->type = type;
+    chunk->original_start = original_start;
+    chunk->original_end = original_end;
+    chunk->modified_start = modified_start;
+    chunk->modified_end = modified_end;
+}
+
+static bool diff_script_exceeds_limits(DiffScript *diff_script, size_t pending_edits)
+{
+    if (diff_script->max_edits > 0 && diff_script->edits + pending_edits > diff_script->max_edits)
+    {
+        diff_script->exceeded_limit = NARWHAL_DIFF_LIMIT_EDITS;
+        return true;
+    }
+
+    if (diff_script->has_deadline)
+    {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+
+        if (now.tv_sec > diff_script->deadline.tv_sec ||
+            (now.tv_sec == diff_script->deadline.tv_sec &&
+             now.tv_usec > diff_script->deadline.tv_usec))
+        {
+            diff_script->exceeded_limit = NARWHAL_DIFF_LIMIT_TIME;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool diff_bisect(const DiffSequences *sequences,
+                        size_t original_start,
+                        size_t original_end,
+                        size_t modified_start,
+                        size_t modified_end,
+                        ptrdiff_t *vectors,
+                        DiffScript *diff_script,
+                        size_t *original_split,
+                        size_t *modified_split)
+{
+    ptrdiff_t original_length = (ptrdiff_t)(original_end - original_start);
+    ptrdiff_t modified_length = (ptrdiff_t)(modified_end - modified_start);
+
+    ptrdiff_t max_d = (original_length + modified_length + 1) / 2;
+    ptrdiff_t v_offset = max_d;
+    ptrdiff_t v_length = 2 * max_d + 2;
+
+    ptrdiff_t *forward = vectors;
+    ptrdiff_t *backward = vectors + v_length;
+
+    for (ptrdiff_t i = 0; i < v_length; i++)
+    {
+        forward[i] = -1;
+        backward[i] = -1;
+    }
+
+    forward[v_offset + 1] = 0;
+    backward[v_offset + 1] = 0;
+
+    ptrdiff_t delta = original_length - modified_length;
+    bool front = delta % 2 != 0;
+
+    ptrdiff_t forward_start = 0;
+    ptrdiff_t forward_end = 0;
+    ptrdiff_t backward_start = 0;
+    ptrdiff_t backward_end = 0;
+
+    for (ptrdiff_t d = 0; d < max_d; d++)
+    {
+        if (diff_script_exceeds_limits(diff_script, (size_t)d))
+        {
+            return false;
+        }
+
+        for (ptrdiff_t k = -d + forward_start; k <= d - forward_end; k += 2)
+        {
+            ptrdiff_t k_offset = v_offset + k;
+            ptrdiff_t x;
+
+            if (k == -d || (k != d && forward[k_offset - 1] < forward[k_offset + 1]))
+            {
+                x = forward[k_offset + 1];
+            }
+            else
+            {
+                x = forward[k_offset - 1] + 1;
+            }
+
+            ptrdiff_t y = x - k;
+
+            while (x < original_length && y < modified_length &&
+                   diff_elements_equal(sequences,
+                                       original_start + (size_t)x,
+                                       modified_start + (size_t)y))
+            {
+                x++;
+                y++;
+            }
+
+            forward[k_offset] = x;
+
+            if (x > original_length)
+            {
+                forward_end += 2;
+            }
+            else if (y > modified_length)
+            {
+                forward_start += 2;
+            }
+            else if (front)
+            {
+                ptrdiff_t backward_offset = v_offset + delta - k;
+
+                if (backward_offset >= 0 && backward_offset < v_length &&
+                    backward[backward_offset] != -1 &&
+                    x >= original_length - backward[backward_offset])
+                {
+                    *original_split = original_start + (size_t)x;
+                    *modified_split = modified_start + (size_t)y;
+                    return true;
+                }
+            }
+        }
+
+        for (ptrdiff_t k = -d + backward_start; k <= d - backward_end; k += 2)
+        {
+            ptrdiff_t k_offset = v_offset + k;
+            ptrdiff_t x;
+
+            if (k == -d || (k != d && backward[k_offset - 1] < backward[k_offset + 1]))
+            {
+                x = backward[k_offset + 1];
+            }
+            else
+            {
+                x = backward[k_offset - 1] + 1;
+            }
+
+            ptrdiff_t y = x - k;
+
+            while (x < original_length && y < modified_length &&
+                   diff_elements_equal(sequences,
+                                       original_end - (size_t)x - 1,
+                                       modified_end - (size_t)y - 1))
+            {
+                x++;
+                y++;
+            }
+
+            backward[k_offset] = x;
+
+            if (x > original_length)
+            {
+                backward_end += 2;
+            }
+            else if (y > modified_length)
+            {
+                backward_start += 2;
+            }
+            else if (!front)
+            {
+                ptrdiff_t forward_offset = v_offset + delta - k;
+
+                if (forward_offset >= 0 && forward_offset < v_length &&
+                    forward[forward_offset] != -1 &&
+                    forward[forward_offset] >= original_length - x)
+                {
+                    ptrdiff_t forward_x = forward[forward_offset];
+                    ptrdiff_t forward_y = v_offset + forward_x - forward_offset;
+
+                    *original_split = original_start + (size_t)forward_x;
+                    *modified_split = modified_start + (size_t)forward_y;
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+static void diff_compare(const DiffSequences *sequences,
+                         size_t original_start,
+                         size_t original_end,
+                         size_t modified_start,
+                         size_t modified_end,
+                         ptrdiff_t *vectors,
+                         DiffScript *diff_script)
+{
+    if (diff_script->exceeded_limit != NARWHAL_DIFF_LIMIT_NONE)
+    {
+        return;
+    }
+
+    size_t prefix = 0;
+
+    while (original_start + prefix < original_end && modified_start + prefix < modified_end &&
+           diff_elements_equal(sequences, original_start + prefix, modified_start + prefix))
+    {
+        prefix++;
+    }
+
+    diff_script_append(diff_script,
+                       NARWHAL_DIFF_CHUNK_TYPE_MATCHED,
+                       original_start,
+                       original_start + prefix,
+                       modified_start,
+                       modified_start + prefix);
+
+    original_start += prefix;
+    modified_start += prefix;
+
+    size_t suffix = 0;
+
+    while (original_start + suffix < original_end && modified_start + suffix < modified_end &&
+           diff_elements_equal(sequences, original_end - suffix - 1, modified_end - suffix - 1))
+    {
+        suffix++;
+    }
+
+    original_end -= suffix;
+    modified_end -= suffix;
+
+    size_t original_split;
+    size_t modified_split;
+
+    if (original_start < original_end && modified_start < modified_end &&
+        diff_bisect(sequences,
+                    original_start,
+                    original_end,
+                    modified_start,
+                    modified_end,
+                    vectors,
+                    diff_script,
+                    &original_split,
+                    &modified_split))
+    {
+        diff_compare(sequences,
+                     original_start,
+                     original_split,
+                     modified_start,
+                     modified_split,
+                     vectors,
+                     diff_script);
+        diff_compare(sequences,
+                     original_split,
+                     original_end,
+                     modified_split,
+                     modified_end,
+                     vectors,
+                     diff_script);
+    }
+    else if (diff_script->exceeded_limit == NARWHAL_DIFF_LIMIT_NONE)
+    {
+        diff_script_append(diff_script,
+                           NARWHAL_DIFF_CHUNK_TYPE_DELETED,
+                           original_start,
+                           original_end,
+                           modified_start,
+                           modified_start);
+        diff_script_append(diff_script,
+                           NARWHAL_DIFF_CHUNK_TYPE_ADDED,
+                           original_end,
+                           original_end,
+                           modified_start,
+                           modified_end);
+    }
+
+    diff_script_append(diff_script,
+                       NARWHAL_DIFF_CHUNK_TYPE_MATCHED,
+                       original_end,
+                       original_end + suffix,
+                       modified_end,
+                       modified_end + suffix);
+}
+
+/*
+ * Patience diff
+ */
+
+static size_t diff_patience_anchors(const DiffSequences *sequences,
+                                    size_t original_start,
+                                    size_t original_end,
+                                    size_t modified_start,
+                                    size_t modified_end,
+                                    DiffPatience *patience,
+                                    size_t *original_anchors,
+                                    size_t *modified_anchors)
+{
+    const size_t *original_ids = sequences->original_ids;
+    const size_t *modified_ids = sequences->modified_ids;
+
+    for (size_t i = original_start; i < original_end; i++)
+    {
+        patience->original_counts[original_ids[i]]++;
+    }
+
+    for (size_t j = modified_start; j < modified_end; j++)
+    {
+        patience->modified_counts[modified_ids[j]]++;
+        patience->modified_positions[modified_ids[j]] = j;
+    }
+
+    size_t original_length = original_end - original_start;
+
+    size_t *candidates = malloc(original_length * sizeof(size_t));
+    size_t *piles = malloc(original_length * sizeof(size_t));
+    size_t *predecessors = malloc(original_length * sizeof(size_t));
+
+    size_t candidate_count = 0;
+    size_t pile_count = 0;
+
+    for (size_t i = original_start; i < original_end; i++)
+    {
+        size_t id = original_ids[i];
+
+        if (patience->original_counts[id] != 1 || patience->modified_counts[id] != 1)
+        {
+            continue;
+        }
+
+        size_t position = patience->modified_positions[id];
+
+        size_t low = 0;
+        size_t high = pile_count;
+
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+
+            if (patience->modified_positions[original_ids[candidates[piles[middle]]]] < position)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        candidates[candidate_count] = i;
+        predecessors[candidate_count] = low > 0 ? piles[low - 1] : SIZE_MAX;
+        piles[low] = candidate_count;
+        candidate_count++;
+
+        if (low == pile_count)
+        {
+            pile_count++;
+        }
+    }
+
+    size_t candidate = pile_count > 0 ? piles[pile_count - 1] : SIZE_MAX;
+
+    for (size_t k = pile_count; k > 0; k--)
+    {
+        size_t anchor = candidates[candidate];
+
+        original_anchors[k - 1] = anchor;
+        modified_anchors[k - 1] = patience->modified_positions[original_ids[anchor]];
+        candidate = predecessors[candidate];
+    }
+
+    free(candidates);
+    free(piles);
+    free(predecessors);
+
+    for (size_t i = original_start; i < original_end; i++)
+    {
+        patience->original_counts[original_ids[i]] = 0;
+    }
+
+    for (size_t j = modified_start; j < modified_end; j++)
+    {
+        patience->modified_counts[modified_ids[j]] = 0;
+    }
+
+    return pile_count;
+}
+
+static void diff_patience(const DiffSequences *sequences,
+                          size_t original_start,
+                          size_t original_end,
+                          size_t modified_start,
+                          size_t modified_end,
+                          ptrdiff_t *vectors,
+                          DiffPatience *patience,
+                          DiffScript *diff_script)
+{
+    if (original_start == original_end || modified_start == modified_end ||
+        diff_script_exceeds_limits(diff_script, 0))
+    {
+        diff_compare(sequences,
+                     original_start,
+                     original_end,
+                     modified_start,
+                     modified_end,
+                     vectors,
+                     diff_script);
+        return;
+    }
+
+    size_t *original_anchors = malloc((original_end - original_start) * sizeof(size_t));
+    size_t *modified_anchors = malloc((original_end - original_start) * sizeof(size_t));
+
+    size_t anchor_count = diff_patience_anchors(sequences,
+                                                original_start,
+                                                original_end,
+                                                modified_start,
+                                                modified_end,
+                                                patience,
+                                                original_anchors,
+                                                modified_anchors);
+
+    if (anchor_count == 0)
+    {
+        free(original_anchors);
+        free(modified_anchors);
+        diff_compare(sequences,
+                     original_start,
+                     original_end,
+                     modified_start,
+                     modified_end,
+                     vectors,
+                     diff_script);
+        return;
+    }
+
+    for (size_t k = 0; k < anchor_count; k++)
+    {
+        size_t original_anchor = original_anchors[k];
+        size_t modified_anchor = modified_anchors[k];
+
+        diff_patience(sequences,
+                      original_start,
+                      original_anchor,
+                      modified_start,
+                      modified_anchor,
+                      vectors,
+                      patience,
+                      diff_script);
+
+        diff_script_append(diff_script,
+                           NARWHAL_DIFF_CHUNK_TYPE_MATCHED,
+                           original_anchor,
+                           original_anchor + 1,
+                           modified_anchor,
+                           modified_anchor + 1);
+
+        original_start = original_anchor + 1;
+        modified_start = modified_anchor + 1;
+    }
+
+    free(original_anchors);
+    free(modified_anchors);
+
+    diff_patience(sequences,
+                  original_start,
+                  original_end,
+                  modified_start,
+                  modified_end,
+                  vectors,
+                  patience,
+                  diff_script);
+}
+
+/*
+ * Bit-parallel diff
+ */
+
+static size_t diff_bit_parallel_minimum_edits(const uint64_t *row,
+                                              size_t length,
+                                              size_t modified_length,
+                                              size_t remaining_columns)
+{
+    // The common subsequence can at best grow by one for each column left to process
+    size_t common = remaining_columns;
+    size_t words = (length + 63) / 64;
+
+    for (size_t w = 0; w < words; w++)
+    {
+        uint64_t zeros = ~row[w];
+
+        if (w == words - 1 && length % 64 != 0)
+        {
+            zeros &= ((uint64_t)1 << (length % 64)) - 1;
+        }
+
+        common += (size_t)__builtin_popcountll(zeros);
+    }
+
+    return 2 * common >= length + modified_length ? 0 : length + modified_length - 2 * common;
+}
+
+static bool diff_bit_parallel_row(const DiffSequences *sequences,
+                                  size_t original_start,
+                                  size_t original_end,
+                                  size_t modified_start,
+                                  size_t modified_end,
+                                  size_t other_columns,
+                                  bool reverse,
+                                  DiffBitParallel *bit_parallel,
+                                  size_t *zero_counts,
+                                  DiffScript *diff_script)
+{
+    size_t length = original_end - original_start;
+    size_t words = (length + 63) / 64;
+
+    uint64_t *masks = bit_parallel->masks;
+    uint64_t *row = bit_parallel->row;
+
+    memset(masks, 0, bit_parallel->slot_count * words * sizeof(uint64_t));
+
+    for (size_t i = 0; i < length; i++)
+    {
+        size_t index = reverse ? original_end - 1 - i : original_start + i;
+        unsigned char character = (unsigned char)sequences->original[index];
+
+        masks[bit_parallel->slots[character] * words + i / 64] |= (uint64_t)1 << (i % 64);
+    }
+
+    for (size_t w = 0; w < words; w++)
+    {
+        row[w] = UINT64_MAX;
+    }
+
+    size_t columns = modified_end - modified_start;
+    size_t work = 0;
+
+    for (size_t j = 0; j < columns; j++)
+    {
+        if (work >= NARWHAL_DIFF_DEADLINE_CHECK_WORDS)
+        {
+            work = 0;
+
+            size_t pending_edits = diff_bit_parallel_minimum_edits(
+                row, length, columns + other_columns, columns - j + other_columns);
+
+            if (diff_script_exceeds_limits(diff_script, pending_edits))
+            {
+                return false;
+            }
+        }
+
+        work += words;
+
+        size_t index = reverse ? modified_end - 1 - j : modified_start + j;
+        unsigned char character = (unsigned char)sequences->modified[index];
+        const uint64_t *mask = masks + bit_parallel->slots[character] * words;
+
+        uint64_t carry = 0;
+
+        for (size_t w = 0; w < words; w++)
+        {
+            uint64_t matches = row[w] & mask[w];
+            uint64_t sum = row[w] + matches;
+            uint64_t overflow = sum < row[w];
+
+            sum += carry;
+            carry = overflow | (sum < carry);
+
+            row[w] = sum | (row[w] & ~mask[w]);
+        }
+    }
+
+    zero_counts[0] = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        uint64_t bit = (row[i / 64] >> (i % 64)) & 1;
+        zero_counts[i + 1] = zero_counts[i] + (bit == 0);
+    }
+
+    return true;
+}
+
+static void diff_bit_parallel(const DiffSequences *sequences,
+                              size_t original_start,
+                              size_t original_end,
+                              size_t modified_start,
+                              size_t modified_end,
+                              ptrdiff_t *vectors,
+                              DiffScript *diff_script)
+{
+    size_t original_length = original_end - original_start;
+    size_t modified_length = modified_end - modified_start;
+
+    // Every byte that one side has in excess needs its own edit
+    size_t minimum_edits = original_length > modified_length ? original_length - modified_length
+                                                             : modified_length - original_length;
+
+    if (original_length < 64 || modified_length < 64 ||
+        diff_script_exceeds_limits(diff_script, minimum_edits))
+    {
+        diff_compare(sequences,
+                     original_start,
+                     original_end,
+                     modified_start,
+                     modified_end,
+                     vectors,
+                     diff_script);
+        return;
+    }
+
+    // Bytes missing from the original share the empty mask in the first slot
+    DiffBitParallel bit_parallel = { .slot_count = 1 };
+
+    for (size_t i = original_start; i < original_end; i++)
+    {
+        unsigned char character = (unsigned char)sequences->original[i];
+
+        if (bit_parallel.slots[character] == 0)
+        {
+            bit_parallel.slots[character] = (uint16_t)bit_parallel.slot_count++;
+        }
+    }
+
+    size_t words = (original_length + 63) / 64;
+
+    bit_parallel.masks = malloc(bit_parallel.slot_count * words * sizeof(uint64_t));
+    bit_parallel.row = malloc(words * sizeof(uint64_t));
+    size_t *forward_counts = malloc((original_length + 1) * sizeof(size_t));
+    size_t *backward_counts = malloc((original_length + 1) * sizeof(size_t));
+
+    size_t modified_split = modified_start + modified_length / 2;
+
+    bool completed = diff_bit_parallel_row(sequences,
+                                           original_start,
+                                           original_end,
+                                           modified_start,
+                                           modified_split,
+                                           modified_end - modified_split,
+                                           false,
+                                           &bit_parallel,
+                                           forward_counts,
+                                           diff_script) &&
+                     diff_bit_parallel_row(sequences,
+                                           original_start,
+                                           original_end,
+                                           modified_split,
+                                           modified_end,
+                                           modified_split - modified_start,
+                                           true,
+                                           &bit_parallel,
+                                           backward_counts,
+                                           diff_script);
+
+    size_t best_split = 0;
+    size_t best_length = 0;
+
+    for (size_t i = 0; completed && i <= original_length; i++)
+    {
+        size_t length = forward_counts[i] + backward_counts[original_length - i];
+
+        if (length > best_length)
+        {
+            best_split = i;
+            best_length = length;
+        }
+    }
+
+    free(bit_parallel.masks);
+    free(bit_parallel.row);
+    free(forward_counts);
+    free(backward_counts);
+
+    // The longest common subsequence gives the exact number of edits left in this range
+    if (!completed ||
+        diff_script_exceeds_limits(diff_script,
+                                   original_length + modified_length - 2 * best_length))
+    {
+        return;
+    }
+
+    size_t original_split = original_start + best_split;
+
+    diff_bit_parallel(sequences,
+                      original_start,
+                      original_split,
+                      modified_start,
+                      modified_split,
+                      vectors,
+                      diff_script);
+    diff_bit_parallel(sequences,
+                      original_split,
+                      original_end,
+                      modified_split,
+                      modified_end,
+                      vectors,
+                      diff_script);
+}
+
+static size_t diff_chunk_length(const NarwhalDiffChunk *chunk)
+{
+    return narwhal_max_size_t(chunk->original_end - chunk->original_start,
+                              chunk->modified_end - chunk->modified_start);
+}
+
+static void diff_script_absorb_small_matches(DiffScript *diff_script)
+{
+    NarwhalDiffChunk *chunks = diff_script->chunks;
+    size_t size = 0;
+
+    for (size_t i = 0; i < diff_script->size; i++)
+    {
+        chunks[size] = chunks[i];
+        size++;
+
+        while (size >= 3 && chunks[size - 1].type != NARWHAL_DIFF_CHUNK_TYPE_MATCHED &&
+               chunks[size - 2].type == NARWHAL_DIFF_CHUNK_TYPE_MATCHED &&
+               chunks[size - 3].type != NARWHAL_DIFF_CHUNK_TYPE_MATCHED &&
+               diff_chunk_length(&chunks[size - 2]) < diff_chunk_length(&chunks[size - 3]) &&
+               diff_chunk_length(&chunks[size - 2]) < diff_chunk_length(&chunks[size - 1]))
+        {
+            NarwhalDiffChunk *merged_chunk = &chunks[size - 3];
+
+            merged_chunk->type = NARWHAL_DIFF_CHUNK_TYPE_REPLACED;
+            merged_chunk->original_end = chunks[size - 1].original_end;
+            merged_chunk->modified_end = chunks[size - 1].modified_end;
+
+            size -= 2;
+        }
+    }
+
+    diff_script->size = size;
+}
+
+static void initialize_diff_script(DiffScript *diff_script, const NarwhalDiffLimits *limits)
+{
+    diff_script->size = 0;
+    diff_script->capacity = 32;
+    diff_script->chunks = malloc(diff_script->capacity * sizeof(NarwhalDiffChunk));
+    diff_script->edits = 0;
+    diff_script->max_edits = limits != NULL ? limits->max_edits : 0;
+    diff_script->has_deadline = limits != NULL && limits->max_milliseconds > 0;
+    diff_script->exceeded_limit = NARWHAL_DIFF_LIMIT_NONE;
+
+    if (diff_script->has_deadline)
+    {
+        gettimeofday(&diff_script->deadline, NULL);
+
+        size_t microseconds =
+            (size_t)diff_script->deadline.tv_usec + limits->max_milliseconds * 1000;
+
+        diff_script->deadline.tv_sec += (time_t)(microseconds / 1000000);
+        diff_script->deadline.tv_usec = (suseconds_t)(microseconds % 1000000);
+    }
+}
+
+static NarwhalDiffLimit diff_sequences(const DiffSequences *sequences,
+                                       size_t original_length,
+                                       size_t modified_length,
+                                       size_t prefix,
+                                       size_t suffix,
+                                       NarwhalDiffAlgorithm algorithm,
+                                       const NarwhalDiffLimits *limits,
+                                       NarwhalDiff *diff)
+{
+    DiffScript diff_script;
+    initialize_diff_script(&diff_script, limits);
+
+    size_t original_end = original_length - suffix;
+    size_t modified_end = modified_length - suffix;
+
+    size_t v_length = 2 * ((original_end - prefix + modified_end - prefix + 1) / 2) + 2;
+    ptrdiff_t *vectors = malloc(2 * v_length * sizeof(ptrdiff_t));
+
+    diff_script_append(&diff_script, NARWHAL_DIFF_CHUNK_TYPE_MATCHED, 0, prefix, 0, prefix);
+
+    if (algorithm == NARWHAL_DIFF_ALGORITHM_PATIENCE && sequences->original_ids != NULL)
+    {
+        DiffPatience patience = { calloc(sequences->id_count, sizeof(size_t)),
+                                  calloc(sequences->id_count, sizeof(size_t)),
+                                  malloc(sequences->id_count * sizeof(size_t)) };
+
+        diff_patience(sequences,
+                      prefix,
+                      original_end,
+                      prefix,
+                      modified_end,
+                      vectors,
+                      &patience,
+                      &diff_script);
+
+        free(patience.original_counts);
+        free(patience.modified_counts);
+        free(patience.modified_positions);
+    }
+    else if (algorithm == NARWHAL_DIFF_ALGORITHM_BIT_PARALLEL && sequences->original_ids == NULL)
+    {
+        diff_bit_parallel(
+            sequences, prefix, original_end, prefix, modified_end, vectors, &diff_script);
+    }
+    else
+    {
+        diff_compare(
+            sequences, prefix, original_end, prefix, modified_end, vectors, &diff_script);
+    }
+
+    diff_script_append(&diff_script,
+                       NARWHAL_DIFF_CHUNK_TYPE_MATCHED,
+                       original_end,
+                       original_length,
+                       modified_end,
+                       modified_length);
+
+    free(vectors);
+
+    if (diff_script.exceeded_limit != NARWHAL_DIFF_LIMIT_NONE)
+    {
+        free(diff_script.chunks);
+        diff->size = 0;
+        diff->chunks = NULL;
+
+        return diff_script.exceeded_limit;
+    }
+
+    if (sequences->original_ids == NULL)
+    {
+        diff_script_absorb_small_matches(&diff_script);
+    }
+
+    diff->size = diff_script.size;
+    diff->chunks = diff_script.chunks;
+
+    if (diff->size == 0)
+    {
+        free(diff->chunks);
+        diff->chunks = NULL;
+    }
+
+    return NARWHAL_DIFF_LIMIT_NONE;
+}
+
+static bool diff_exceeds_size(const NarwhalDiffLimits *limits,
+                              size_t original_size,
+                              size_t modified_size,
+                              NarwhalDiff *diff)
+{
+    if (limits == NULL || limits->max_size == 0 ||
+        original_size + modified_size <= limits->max_size)
+    {
+        return false;
+    }
+
+    diff->size = 0;
+    diff->chunks = NULL;
+
+    return true;
+}
+
+/*
+ * Line index
+ */
+
+static size_t *diff_line_offsets(const char *string, size_t size, size_t line_count)
+{
+    size_t *line_offsets = malloc((line_count + 1) * sizeof(size_t));
+    narwhal_index_lines(string, size, line_offsets);
+
+    return line_offsets;
+}
+
+static void initialize_diff_line_table(DiffLineTable *line_table, size_t line_count)
+{
+    line_table->capacity = 16;
+
+    while (line_table->capacity < 2 * line_count)
+    {
+        line_table->capacity *= 2;
+    }
+
+    line_table->slots = calloc(line_table->capacity, sizeof(size_t));
+    line_table->count = 0;
+    line_table->lines = malloc((line_count + 1) * sizeof(const char *));
+    line_table->lengths = malloc((line_count + 1) * sizeof(size_t));
+    line_table->hashes = malloc((line_count + 1) * sizeof(uint64_t));
+}
+
+static size_t diff_line_table_intern(DiffLineTable *line_table, const char *line, size_t length)
+{
+    uint64_t hash = narwhal_hash_bytes(line, length);
+    size_t mask = line_table->capacity - 1;
+
+    for (size_t slot = (size_t)hash & mask;; slot = (slot + 1) & mask)
+    {
+        size_t entry = line_table->slots[slot];
+
+        if (entry == 0)
+        {
+            size_t id = line_table->count;
+            line_table->count++;
+
+            line_table->slots[slot] = id + 1;
+            line_table->lines[id] = line;
+            line_table->lengths[id] = length;
+            line_table->hashes[id] = hash;
+
+            return id;
+        }
+
+        size_t id = entry - 1;
+
+        if (line_table->hashes[id] == hash && line_table->lengths[id] == length &&
+            memcmp(line_table->lines[id], line, length) == 0)
+        {
+            return id;
+        }
+    }
+}
+
+static void diff_line_table_intern_range(DiffLineTable *line_table,
+                                         const char *string,
+                                         const size_t *line_offsets,
+                                         size_t start,
+                                         size_t end,
+                                         size_t *line_ids)
+{
+    for (size_t i = start; i < end; i++)
+    {
+        size_t line_length = line_offsets[i + 1] - line_offsets[i] - 1;
+        line_ids[i] = diff_line_table_intern(line_table, string + line_offsets[i], line_length);
+    }
+}
+
+static void free_diff_line_table(DiffLineTable *line_table)
+{
+    free(line_table->slots);
+    free(line_table->lines);
+    free(line_table->lengths);
+    free(line_table->hashes);
+}
+
 /*
  * Higher-level wrappers
  */
 
+NarwhalDiffLimit narwhal_diff_strings_limited(const char *original,
+                                              size_t original_length,
+                                              const char *modified,
+                                              size_t modified_length,
+                                              NarwhalDiffAlgorithm algorithm,
+                                              const NarwhalDiffLimits *limits,
+                                              NarwhalDiff *diff)
+{
+    if (diff_exceeds_size(limits, original_length, modified_length, diff))
+    {
+        return NARWHAL_DIFF_LIMIT_SIZE;
+    }
+
+    size_t shortest_length = narwhal_min_size_t(original_length, modified_length);
+
+    size_t prefix = narwhal_common_prefix_length(original, modified, shortest_length);
+    size_t suffix = narwhal_common_suffix_length(
+        original + original_length, modified + modified_length, shortest_length - prefix);
+
+    DiffSequences sequences = { original, modified, NULL, NULL, 0 };
+    return diff_sequences(&sequences,
+                          original_length,
+                          modified_length,
+                          prefix,
+                          suffix,
+                          algorithm,
+                          limits,
+                          diff);
+}
+
+NarwhalDiffLimit narwhal_diff_lines_limited(const char *original,
+                                            const char *modified,
+                                            NarwhalDiffAlgorithm algorithm,
+                                            const NarwhalDiffLimits *limits,
+                                            NarwhalDiff *diff)
+{
+    size_t original_size = strlen(original);
+    size_t modified_size = strlen(modified);
+
+    if (diff_exceeds_size(limits, original_size, modified_size, diff))
+    {
+        return NARWHAL_DIFF_LIMIT_SIZE;
+    }
+
+    size_t original_length = narwhal_count_bytes(original, original_size, '\n') + 1;
+    size_t modified_length = narwhal_count_bytes(modified, modified_size, '\n') + 1;
+
+    size_t *original_lines = diff_line_offsets(original, original_size, original_length);
+    size_t *modified_lines = diff_line_offsets(modified, modified_size, modified_length);
+
+    size_t shortest_size = narwhal_min_size_t(original_size, modified_size);
+
+    size_t prefix_size = narwhal_common_prefix_length(original, modified, shortest_size);
+    size_t suffix_size = narwhal_common_suffix_length(
+        original + original_size, modified + modified_size, shortest_size - prefix_size);
+
+    size_t shortest_length = narwhal_min_size_t(original_length, modified_length);
+
+    size_t prefix = narwhal_min_size_t(narwhal_count_bytes(original, prefix_size, '\n'),
+                                       shortest_length);
+    size_t suffix =
+        narwhal_min_size_t(narwhal_count_bytes(original + original_size - suffix_size,
+                                               suffix_size,
+                                               '\n'),
+                           shortest_length - prefix);
+
+    size_t *original_ids = malloc(original_length * sizeof(size_t));
+    size_t *modified_ids = malloc(modified_length * sizeof(size_t));
+
+    DiffLineTable line_table;
+    initialize_diff_line_table(&line_table,
+                               original_length + modified_length - 2 * (prefix + suffix));
+
+    diff_line_table_intern_range(&line_table,
+                                 original,
+                                 original_lines,
+                                 prefix,
+                                 original_length - suffix,
+                                 original_ids);
+    diff_line_table_intern_range(&line_table,
+                                 modified,
+                                 modified_lines,
+                                 prefix,
+                                 modified_length - suffix,
+                                 modified_ids);
+
+    size_t id_count = line_table.count;
+
+    free_diff_line_table(&line_table);
+    free(original_lines);
+    free(modified_lines);
+
+    DiffSequences sequences = { original, modified, original_ids, modified_ids, id_count };
+    NarwhalDiffLimit exceeded_limit = diff_sequences(&sequences,
+                                                     original_length,
+                                                     modified_length,
+                                                     prefix,
+                                                     suffix,
+                                                     algorithm,
+                                                     limits,
+                                                     diff);
+
+    free(original_ids);
+    free(modified_ids);
+
+    return exceeded_limit;
+}
+
 NarwhalDiff narwhal_diff_strings_lengths(const char *original,
                                          size_t original_length,
                                          const char *modified,
                                          size_t modified_length)
 {
-    NarwhalDiffMatrix *diff_matrix =
-        narwhal_new_diff_matrix_from_lengths(original_length, modified_length);
-
-    narwhal_diff_matrix_fill_from_strings(diff_matrix, original, modified);
-
-    NarwhalDiff diff = narwhal_diff_matrix_get_diff(diff_matrix);
-
-    narwhal_free_diff_matrix(diff_matrix);
+    NarwhalDiff diff;
+    narwhal_diff_strings_limited(original,
+                                 original_length,
+                                 modified,
+                                 modified_length,
+                                 NARWHAL_DIFF_ALGORITHM_MYERS,
+                                 NULL,
+                                 &diff);
 
     return diff;
 }
@@ -277,17 +1436,8 @@ NarwhalDiff narwhal_diff_strings(const char *original, const char *modified)
 
 NarwhalDiff narwhal_diff_lines(const char *original, const char *modified)
 {
-    size_t original_length = narwhal_count_chars(original, '\n') + 1;
-    size_t modified_length = narwhal_count_chars(modified, '\n') + 1;
-
-    NarwhalDiffMatrix *diff_matrix =
-        narwhal_new_diff_matrix_from_lengths(original_length, modified_length);
-
-    narwhal_diff_matrix_fill_from_lines(diff_matrix, original, modified);
-
-    NarwhalDiff diff = narwhal_diff_matrix_get_diff(diff_matrix);
-
-    narwhal_free_diff_matrix(diff_matrix);
+    NarwhalDiff diff;
+    narwhal_diff_lines_limited(original, modified, NARWHAL_DIFF_ALGORITHM_MYERS, NULL, &diff);
 
     return diff;
 }
@@ -5,6 +5,8 @@
 
 #include "narwhal/types.h"
 
+#define NARWHAL_DIFF_DEADLINE_CHECK_WORDS ((size_t)1 << 20)
+
 struct NarwhalDiffMatrix
 {
     size_t rows;
@@ -20,6 +22,28 @@ enum NarwhalDiffChunkType
     NARWHAL_DIFF_CHUNK_TYPE_DELETED
 };
 
+enum NarwhalDiffAlgorithm
+{
+    NARWHAL_DIFF_ALGORITHM_MYERS,
+    NARWHAL_DIFF_ALGORITHM_PATIENCE,
+    NARWHAL_DIFF_ALGORITHM_BIT_PARALLEL
+};
+
+enum NarwhalDiffLimit
+{
+    NARWHAL_DIFF_LIMIT_NONE,
+    NARWHAL_DIFF_LIMIT_SIZE,
+    NARWHAL_DIFF_LIMIT_EDITS,
+    NARWHAL_DIFF_LIMIT_TIME
+};
+
+struct NarwhalDiffLimits
+{
+    size_t max_size;
+    size_t max_edits;
+    size_t max_milliseconds;
+};
+
 struct NarwhalDiff
 {
     size_t size;
@@ -53,6 +77,18 @@ void narwhal_diff_matrix_set(const NarwhalDiffMatrix *diff_matrix,
                              size_t column,
                              int value);
 
+NarwhalDiffLimit narwhal_diff_strings_limited(const char *original,
+                                              size_t original_length,
+                                              const char *modified,
+                                              size_t modified_length,
+                                              NarwhalDiffAlgorithm algorithm,
+                                              const NarwhalDiffLimits *limits,
+                                              NarwhalDiff *diff);
+NarwhalDiffLimit narwhal_diff_lines_limited(const char *original,
+                                            const char *modified,
+                                            NarwhalDiffAlgorithm algorithm,
+                                            const NarwhalDiffLimits *limits,
+                                            NarwhalDiff *diff);
 NarwhalDiff narwhal_diff_strings_lengths(const char *original,
                                          size_t original_length,
                                          const char *modified,
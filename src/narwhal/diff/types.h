@@ -3,6 +3,9 @@
 
 typedef struct NarwhalDiffMatrix NarwhalDiffMatrix;
 typedef enum NarwhalDiffChunkType NarwhalDiffChunkType;
+typedef enum NarwhalDiffAlgorithm NarwhalDiffAlgorithm;
+typedef enum NarwhalDiffLimit NarwhalDiffLimit;
+typedef struct NarwhalDiffLimits NarwhalDiffLimits;
 typedef struct NarwhalDiff NarwhalDiff;
 typedef struct NarwhalDiffChunk NarwhalDiffChunk;
 
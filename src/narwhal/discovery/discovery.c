@@ -1,6 +1,9 @@
 #include "narwhal/discovery/discovery.h"
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "narwhal/group/group.h"
 
@@ -10,6 +13,37 @@
 
 static NarwhalTestDiscoveryQueue *_narwhal_global_test_discovery_queue = NULL;
 
+/*
+ * Discovery section
+ */
+
+#if defined(__GNUC__) && defined(__ELF__)
+
+extern NarwhalTestDescriptor __start_narwhal_tests[] __attribute__((weak));
+extern NarwhalTestDescriptor __stop_narwhal_tests[] __attribute__((weak));
+
+size_t narwhal_discovered_tests(const NarwhalTestDescriptor **descriptors)
+{
+    *descriptors = __start_narwhal_tests;
+
+    if (__start_narwhal_tests == NULL || __stop_narwhal_tests == NULL)
+    {
+        return 0;
+    }
+
+    return (size_t)(__stop_narwhal_tests - __start_narwhal_tests);
+}
+
+#else
+
+size_t narwhal_discovered_tests(const NarwhalTestDescriptor **descriptors)
+{
+    *descriptors = NULL;
+    return 0;
+}
+
+#endif
+
 /*
  * Register test
  */
@@ -40,10 +74,63 @@ void narwhal_add_test_to_discovery_queue(NarwhalTestDiscoveryQueue *test_entry,
  * Create test group from discovery queue
  */
 
+static int compare_descriptor_lines(const void *a, const void *b)
+{
+    const NarwhalTestDescriptor *first = *(const NarwhalTestDescriptor *const *)a;
+    const NarwhalTestDescriptor *second = *(const NarwhalTestDescriptor *const *)b;
+
+    return (first->line_number > second->line_number) - (first->line_number < second->line_number);
+}
+
+static bool same_file(const NarwhalTestDescriptor *first, const NarwhalTestDescriptor *second)
+{
+    return first->filename == second->filename || strcmp(first->filename, second->filename) == 0;
+}
+
 NarwhalTestGroup *narwhal_discover_tests()
 {
-    return narwhal_collect_tests_from_discovery_queue("root",
-                                                      _narwhal_global_test_discovery_queue);
+    NarwhalTestGroup *test_group = narwhal_collect_tests_from_discovery_queue(
+        "root", _narwhal_global_test_discovery_queue);
+
+    const NarwhalTestDescriptor *descriptors;
+    size_t descriptor_count = narwhal_discovered_tests(&descriptors);
+
+    if (descriptor_count == 0)
+    {
+        return test_group;
+    }
+
+    // The compiler is free to emit the descriptors of a translation unit in any order so each
+    // contiguous run of descriptors coming from the same file is sorted by line number.
+
+    const NarwhalTestDescriptor **ordered = malloc(descriptor_count * sizeof(*ordered));
+    size_t run_start = 0;
+
+    for (size_t i = 0; i < descriptor_count; i++)
+    {
+        ordered[i] = &descriptors[i];
+
+        if (i + 1 == descriptor_count || !same_file(&descriptors[i], &descriptors[i + 1]))
+        {
+            qsort(ordered + run_start,
+                  i + 1 - run_start,
+                  sizeof(*ordered),
+                  compare_descriptor_lines);
+            run_start = i + 1;
+        }
+    }
+
+    for (size_t i = 0; i < descriptor_count; i++)
+    {
+        if (ordered[i]->test_handle != NULL)
+        {
+            ordered[i]->test_handle(test_group);
+        }
+    }
+
+    free(ordered);
+
+    return test_group;
 }
 
 NarwhalTestGroup *narwhal_collect_tests_from_discovery_queue(const char *group_name,
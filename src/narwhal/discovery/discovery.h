@@ -1,6 +1,8 @@
 #ifndef NARWHAL_DISCOVERY_H
 #define NARWHAL_DISCOVERY_H
 
+#include <stdlib.h>
+
 #include "narwhal/concat_macro.h"
 #include "narwhal/types.h"
 
@@ -10,10 +12,20 @@ struct NarwhalTestDiscoveryQueue
     NarwhalTestDiscoveryQueue *next;
 };
 
+struct NarwhalTestDescriptor
+{
+    const char *name;
+    const char *filename;
+    size_t line_number;
+    NarwhalGroupItemRegistration test_handle;
+};
+
 void narwhal_register_test_for_discovery(NarwhalTestDiscoveryQueue *test_entry);
 void narwhal_add_test_to_discovery_queue(NarwhalTestDiscoveryQueue *test_entry,
                                          NarwhalTestDiscoveryQueue **queue);
 
+size_t narwhal_discovered_tests(const NarwhalTestDescriptor **descriptors);
+
 NarwhalTestGroup *narwhal_discover_tests();
 NarwhalTestGroup *narwhal_collect_tests_from_discovery_queue(const char *group_name,
                                                              NarwhalTestDiscoveryQueue *queue);
@@ -25,6 +37,18 @@ NarwhalTestGroup *narwhal_collect_tests_from_discovery_queue(const char *group_n
                     DISABLE_TEST_DISCOVERY)                                 \
     (test_name)
 
+#ifdef __ELF__
+
+#define _NARWHAL_DISCOVERY_SECTION "narwhal_tests"
+
+#define _NARWHAL_REGISTER_TEST_FOR_DISCOVERY_WHEN_DISABLED_IS_0(test_name)                   \
+    __attribute__((used,                                                                     \
+                   section(_NARWHAL_DISCOVERY_SECTION),                                      \
+                   aligned(__alignof__(NarwhalTestDescriptor)))) static NarwhalTestDescriptor \
+        _narwhal_test_descriptor_##test_name = { #test_name, __FILE__, __LINE__, test_name };
+
+#else
+
 #define _NARWHAL_REGISTER_TEST_FOR_DISCOVERY_WHEN_DISABLED_IS_0(test_name)               \
     __attribute__((constructor)) static void _narwhal_test_constructor_##test_name(void) \
     {                                                                                    \
@@ -32,6 +56,8 @@ NarwhalTestGroup *narwhal_collect_tests_from_discovery_queue(const char *group_n
         narwhal_register_test_for_discovery(&test_entry);                                \
     }
 
+#endif
+
 #define _NARWHAL_REGISTER_TEST_FOR_DISCOVERY_WHEN_DISABLED_IS_DISABLE_TEST_DISCOVERY(test_name) \
     _NARWHAL_REGISTER_TEST_FOR_DISCOVERY_WHEN_DISABLED_IS_0(test_name)
 
@@ -2,5 +2,6 @@
 #define NARWHAL_DISCOVERY_TYPES_H
 
 typedef struct NarwhalTestDiscoveryQueue NarwhalTestDiscoveryQueue;
+typedef struct NarwhalTestDescriptor NarwhalTestDescriptor;
 
 #endif
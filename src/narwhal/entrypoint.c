@@ -2,15 +2,9 @@
 
 #ifdef __GNUC__
 
-__attribute__((weak)) int main(void)
+__attribute__((weak)) int main(int argc, char *argv[])
 {
-    NarwhalTestGroup *root_group = narwhal_discover_tests();
-
-    int status = narwhal_run_root_group(root_group);
-
-    narwhal_free_test_group(root_group);
-
-    return status;
+    return narwhal_main(argc, argv);
 }
 
 #endif
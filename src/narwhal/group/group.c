@@ -1,25 +1,85 @@
 #include "narwhal/group/group.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "narwhal/collection/collection.h"
+#include "narwhal/options/options.h"
+#include "narwhal/selector/selector.h"
 #include "narwhal/test/test.h"
 
 /*
  * Group creation
  */
 
+static bool has_selectors(void)
+{
+    const NarwhalCollection *selectors = _narwhal_current_options->selectors;
+    return selectors != NULL && selectors->count > 0;
+}
+
+static size_t full_name_size(const NarwhalTestGroup *parent_group, const char *name)
+{
+    size_t name_size = strlen(name) + 1;
+
+    if (parent_group->full_name == NULL)
+    {
+        return name_size;
+    }
+
+    return strlen(parent_group->full_name) + 1 + name_size;
+}
+
+static void write_full_name(char *full_name,
+                            const NarwhalTestGroup *parent_group,
+                            const char *name)
+{
+    if (parent_group->full_name == NULL)
+    {
+        strcpy(full_name, name);
+        return;
+    }
+
+    size_t parent_length = strlen(parent_group->full_name);
+
+    memcpy(full_name, parent_group->full_name, parent_length);
+    full_name[parent_length] = '/';
+    strcpy(full_name + parent_length + 1, name);
+}
+
 static void initialize_test_group(NarwhalTestGroup *test_group,
                                   const char *name,
+                                  char *full_name,
+                                  NarwhalTestGroup *parent_group,
                                   NarwhalGroupItemRegistration *group_items,
                                   size_t item_count)
 {
     test_group->name = name;
+    test_group->full_name = full_name;
     test_group->only = false;
-    test_group->group = NULL;
-    test_group->subgroups = narwhal_empty_collection();
-    test_group->tests = narwhal_empty_collection();
+    test_group->selected = !has_selectors();
+    test_group->materialized = false;
+    test_group->scanned = false;
+    test_group->test_count = 0;
+    test_group->group = parent_group;
+    test_group->group_items = group_items;
+    test_group->item_count = item_count;
+    test_group->subgroups = NULL;
+    test_group->tests = NULL;
 
+    if (parent_group != NULL && !test_group->selected)
+    {
+        const NarwhalCollection *selectors = _narwhal_current_options->selectors;
+        test_group->selected =
+            parent_group->selected || narwhal_selectors_match(selectors, full_name);
+    }
+}
+
+static void register_group_items(NarwhalTestGroup *test_group,
+                                 NarwhalGroupItemRegistration *group_items,
+                                 size_t item_count)
+{
     for (size_t i = 0; i < item_count; i++)
     {
         NarwhalGroupItemRegistration registration = group_items[i];
@@ -32,29 +92,120 @@ NarwhalTestGroup *narwhal_new_test_group(const char *name,
                                          size_t item_count)
 {
     NarwhalTestGroup *test_group = malloc(sizeof(NarwhalTestGroup));
-    initialize_test_group(test_group, name, group_items, item_count);
+    initialize_test_group(test_group, name, NULL, NULL, group_items, item_count);
+    narwhal_materialize_test_group(test_group);
 
     return test_group;
 }
 
+/*
+ * Materialization
+ */
+
+static void scan_test_group(NarwhalTestGroup *test_group)
+{
+    test_group->only = false;
+    test_group->test_count = 0;
+    test_group->subgroups = narwhal_empty_collection();
+
+    register_group_items(test_group, test_group->group_items, test_group->item_count);
+
+    test_group->scanned = true;
+}
+
+void narwhal_materialize_test_group(NarwhalTestGroup *test_group)
+{
+    if (test_group->materialized)
+    {
+        return;
+    }
+
+    test_group->materialized = true;
+    test_group->tests = narwhal_empty_collection();
+
+    if (!test_group->scanned)
+    {
+        scan_test_group(test_group);
+        return;
+    }
+
+    // The subgroups were kept when the group was scanned, so this only creates the tests
+    register_group_items(test_group, test_group->group_items, test_group->item_count);
+}
+
+static bool has_only_modifier(NarwhalTestModifierRegistration *test_modifiers,
+                              size_t modifier_count)
+{
+    // Scanning doesn't run the modifiers, so any modifier that changes which tests run
+    // needs to be recognized here by its registration function
+    for (size_t i = 0; i < modifier_count; i++)
+    {
+        if (test_modifiers[i].function == narwhal_test_set_only.function)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /*
  * Group items registration
  */
 
+bool narwhal_test_group_selects(const NarwhalTestGroup *test_group, const char *name)
+{
+    if (test_group->selected)
+    {
+        return true;
+    }
+
+    char full_name[full_name_size(test_group, name)];
+    write_full_name(full_name, test_group, name);
+
+    return narwhal_selectors_match(_narwhal_current_options->selectors, full_name);
+}
+
 void narwhal_register_subgroup(NarwhalTestGroup *test_group,
                                const char *name,
                                NarwhalGroupItemRegistration *group_items,
                                size_t item_count)
 {
-    NarwhalTestGroup *subgroup = narwhal_new_test_group(name, group_items, item_count);
-    subgroup->group = test_group;
+    if (test_group->scanned)
+    {
+        return;
+    }
 
-    narwhal_collection_append(test_group->subgroups, subgroup);
+    const NarwhalCollection *selectors = _narwhal_current_options->selectors;
+
+    char full_name[full_name_size(test_group, name)];
+    write_full_name(full_name, test_group, name);
+
+    if (!test_group->selected && !narwhal_selectors_match(selectors, full_name) &&
+        !narwhal_selectors_may_match_within(selectors, full_name))
+    {
+        return;
+    }
+
+    NarwhalTestGroup *subgroup = malloc(sizeof(NarwhalTestGroup));
+    initialize_test_group(
+        subgroup, name, strdup(full_name), test_group, group_items, item_count);
+    scan_test_group(subgroup);
+
+    if (subgroup->test_count == 0)
+    {
+        narwhal_free_test_group(subgroup);
+        return;
+    }
+
+    test_group->test_count += subgroup->test_count;
 
     if (subgroup->only)
     {
         test_group->only = true;
     }
+
+    narwhal_collection_append(test_group->subgroups, subgroup);
 }
 
 void narwhal_register_test(NarwhalTestGroup *test_group,
@@ -66,6 +217,28 @@ void narwhal_register_test(NarwhalTestGroup *test_group,
                            size_t modifier_count,
                            NarwhalResetAllMocksFunction reset_all_mocks)
 {
+    if (!narwhal_test_group_selects(test_group, name))
+    {
+        return;
+    }
+
+    if (!test_group->materialized)
+    {
+        test_group->test_count++;
+
+        if (has_only_modifier(test_modifiers, modifier_count))
+        {
+            test_group->only = true;
+        }
+
+        return;
+    }
+
+    if (!test_group->scanned)
+    {
+        test_group->test_count++;
+    }
+
     NarwhalTest *test = narwhal_new_test(
         name, filename, line_number, function, test_modifiers, modifier_count, reset_all_mocks);
     test->group = test_group;
@@ -84,19 +257,26 @@ void narwhal_register_test(NarwhalTestGroup *test_group,
 
 void narwhal_free_test_group(NarwhalTestGroup *test_group)
 {
-    while (test_group->subgroups->count > 0)
+    if (test_group->scanned)
     {
-        NarwhalTestGroup *subgroup = narwhal_collection_pop(test_group->subgroups);
-        narwhal_free_test_group(subgroup);
+        while (test_group->subgroups->count > 0)
+        {
+            NarwhalTestGroup *subgroup = narwhal_collection_pop(test_group->subgroups);
+            narwhal_free_test_group(subgroup);
+        }
+        narwhal_free_collection(test_group->subgroups);
     }
-    narwhal_free_collection(test_group->subgroups);
 
-    while (test_group->tests->count > 0)
+    if (test_group->materialized)
     {
-        NarwhalTest *test = narwhal_collection_pop(test_group->tests);
-        narwhal_free_test(test);
+        while (test_group->tests->count > 0)
+        {
+            NarwhalTest *test = narwhal_collection_pop(test_group->tests);
+            narwhal_free_test(test);
+        }
+        narwhal_free_collection(test_group->tests);
     }
-    narwhal_free_collection(test_group->tests);
 
+    free(test_group->full_name);
     free(test_group);
 }
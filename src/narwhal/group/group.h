@@ -10,8 +10,15 @@
 struct NarwhalTestGroup
 {
     const char *name;
+    char *full_name;
     bool only;
+    bool selected;
+    bool materialized;
+    bool scanned;
+    size_t test_count;
     NarwhalTestGroup *group;
+    NarwhalGroupItemRegistration *group_items;
+    size_t item_count;
     NarwhalCollection *subgroups;
     NarwhalCollection *tests;
 };
@@ -31,6 +38,8 @@ void narwhal_register_test(NarwhalTestGroup *test_group,
                            NarwhalTestModifierRegistration *test_modifiers,
                            size_t modifier_count,
                            NarwhalResetAllMocksFunction reset_all_mocks);
+bool narwhal_test_group_selects(const NarwhalTestGroup *test_group, const char *name);
+void narwhal_materialize_test_group(NarwhalTestGroup *test_group);
 
 void narwhal_free_test_group(NarwhalTestGroup *test_group);
 
@@ -1,65 +1,303 @@
 #include "narwhal/hexdump/hexdump.h"
 
-#include <ctype.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "narwhal/test/test.h"
+#include "narwhal/utils.h"
 
-char *narwhal_hexdump(const uint8_t *buffer, size_t size, size_t bytes_per_row)
+typedef struct
 {
-    size_t dump_size;
-    char *dump;
-    FILE *stream = open_memstream(&dump, &dump_size);
+    size_t start_row;
+    size_t end_row;
+    size_t mismatch;
+} HexdumpRegion;
+
+static const char hexdump_digits[] = "0123456789ABCDEF";
+
+/*
+ * Row formatting
+ */
+
+static size_t hexdump_offset_width(size_t size)
+{
+    size_t width = 6;
+
+    while (width < sizeof(size_t) * 2 && (size >> (width * 4)) != 0)
+    {
+        width++;
+    }
 
-    size_t offset = 0;
+    return width;
+}
 
-    while (offset < size)
+static size_t hexdump_row_length(size_t bytes_per_row, size_t offset_width)
+{
+    return offset_width + 2 + bytes_per_row * 4 + 1;
+}
+
+static char *hexdump_write_offset(char *output, size_t offset, size_t offset_width)
+{
+    for (size_t i = offset_width; i > 0; i--)
     {
-        fprintf(stream, "%06lX  ", offset);
+        *output++ = hexdump_digits[(offset >> ((i - 1) * 4)) & 0xf];
+    }
 
-        for (size_t i = 0; i < bytes_per_row; i++)
+    return output;
+}
+
+static char *hexdump_write_row(char *output,
+                               const uint8_t *buffer,
+                               size_t size,
+                               size_t offset,
+                               size_t bytes_per_row,
+                               size_t offset_width)
+{
+    output = hexdump_write_offset(output, offset, offset_width);
+    *output++ = ' ';
+    *output++ = ' ';
+
+    for (size_t i = 0; i < bytes_per_row; i++)
+    {
+        if (offset + i < size)
         {
-            if (offset + i < size)
-            {
-                fprintf(stream, "%02X ", buffer[offset + i]);
-            }
-            else
-            {
-                fprintf(stream, "-- ");
-            }
+            uint8_t byte = buffer[offset + i];
+            *output++ = hexdump_digits[byte >> 4];
+            *output++ = hexdump_digits[byte & 0xf];
+        }
+        else
+        {
+            *output++ = '-';
+            *output++ = '-';
         }
 
-        fprintf(stream, " ");
+        *output++ = ' ';
+    }
+
+    *output++ = ' ';
 
-        for (size_t i = 0; i < bytes_per_row; i++)
+    for (size_t i = 0; i < bytes_per_row; i++)
+    {
+        if (offset + i < size)
         {
-            if (offset + i < size)
-            {
-                uint8_t byte = buffer[offset + i];
-                fprintf(stream, "%c", isprint(byte) ? byte : '.');
-            }
-            else
-            {
-                fprintf(stream, " ");
-            }
+            uint8_t byte = buffer[offset + i];
+            *output++ = byte >= 0x20 && byte < 0x7f ? (char)byte : '.';
+        }
+        else
+        {
+            *output++ = ' ';
         }
+    }
 
-        offset += bytes_per_row;
+    return output;
+}
 
-        if (offset < size)
+static char *hexdump_write_rows(char *output,
+                                const uint8_t *buffer,
+                                size_t size,
+                                size_t start_row,
+                                size_t end_row,
+                                size_t bytes_per_row,
+                                size_t offset_width)
+{
+    for (size_t row = start_row; row < end_row; row++)
+    {
+        if (row > start_row)
         {
-            fprintf(stream, "\n");
+            *output++ = '\n';
         }
+
+        output = hexdump_write_row(
+            output, buffer, size, row * bytes_per_row, bytes_per_row, offset_width);
     }
 
-    fclose(stream);
+    return output;
+}
+
+char *narwhal_hexdump(const uint8_t *buffer, size_t size, size_t bytes_per_row)
+{
+    size_t offset_width = hexdump_offset_width(size);
+    size_t row_count = (size + bytes_per_row - 1) / bytes_per_row;
+
+    char *dump = malloc(row_count * (hexdump_row_length(bytes_per_row, offset_width) + 1) + 1);
+    char *end = hexdump_write_rows(dump, buffer, size, 0, row_count, bytes_per_row, offset_width);
+    *end = '\0';
 
     auto_free(dump);
 
     return dump;
 }
 
+/*
+ * Mismatch windows
+ */
+
+static size_t hexdump_next_mismatch(const uint8_t *actual,
+                                    const uint8_t *expected,
+                                    size_t size,
+                                    size_t offset)
+{
+    if (offset >= size)
+    {
+        return size;
+    }
+
+    const char *actual_bytes = (const char *)actual + offset;
+    const char *expected_bytes = (const char *)expected + offset;
+
+    return offset + narwhal_common_prefix_length(actual_bytes, expected_bytes, size - offset);
+}
+
+static size_t hexdump_find_regions(const uint8_t *actual,
+                                   const uint8_t *expected,
+                                   size_t size,
+                                   size_t bytes_per_row,
+                                   size_t context_rows,
+                                   HexdumpRegion *regions,
+                                   bool *truncated)
+{
+    size_t row_count = (size + bytes_per_row - 1) / bytes_per_row;
+    size_t region_count = 0;
+    size_t mismatch = hexdump_next_mismatch(actual, expected, size, 0);
+
+    *truncated = false;
+
+    while (mismatch < size)
+    {
+        size_t row = mismatch / bytes_per_row;
+        size_t start_row = row > context_rows ? row - context_rows : 0;
+        size_t end_row = narwhal_min_size_t(row + context_rows + 1, row_count);
+
+        if (region_count > 0 && start_row <= regions[region_count - 1].end_row)
+        {
+            regions[region_count - 1].end_row = end_row;
+        }
+        else if (region_count < NARWHAL_HEXDUMP_MAX_REGIONS)
+        {
+            regions[region_count++] = (HexdumpRegion){ start_row, end_row, mismatch };
+        }
+        else
+        {
+            *truncated = true;
+            break;
+        }
+
+        mismatch = hexdump_next_mismatch(actual, expected, size, (row + 1) * bytes_per_row);
+    }
+
+    return region_count;
+}
+
+static char *hexdump_write_regions(const uint8_t *buffer,
+                                   size_t size,
+                                   size_t bytes_per_row,
+                                   const char *header,
+                                   const HexdumpRegion *regions,
+                                   size_t region_count,
+                                   bool truncated)
+{
+    size_t offset_width = hexdump_offset_width(size);
+    size_t row_length = hexdump_row_length(bytes_per_row, offset_width);
+
+    size_t separator_length = 64;
+    size_t dump_size = strlen(header) + 1 + (region_count + 1) * separator_length + 1;
+
+    for (size_t i = 0; i < region_count; i++)
+    {
+        dump_size += (regions[i].end_row - regions[i].start_row) * (row_length + 1);
+    }
+
+    char *dump = malloc(dump_size);
+    char *output = dump + sprintf(dump, "%s", header);
+
+    size_t previous_end = 0;
+
+    for (size_t i = 0; i < region_count; i++)
+    {
+        if (regions[i].start_row > previous_end)
+        {
+            output += snprintf(output,
+                               separator_length,
+                               "\n...  %zu identical bytes",
+                               (regions[i].start_row - previous_end) * bytes_per_row);
+        }
+
+        *output++ = '\n';
+        output = hexdump_write_rows(output,
+                                    buffer,
+                                    size,
+                                    regions[i].start_row,
+                                    regions[i].end_row,
+                                    bytes_per_row,
+                                    offset_width);
+
+        previous_end = regions[i].end_row;
+    }
+
+    size_t remaining = size - narwhal_min_size_t(previous_end * bytes_per_row, size);
+
+    if (remaining > 0)
+    {
+        output += snprintf(output,
+                           separator_length,
+                           truncated ? "\n...  %zu bytes not shown"
+                                     : "\n...  %zu identical bytes",
+                           remaining);
+    }
+
+    *output = '\0';
+
+    auto_free(dump);
+
+    return dump;
+}
+
+void narwhal_hexdump_mismatches(const uint8_t *actual,
+                                const uint8_t *expected,
+                                size_t size,
+                                size_t bytes_per_row,
+                                size_t context_rows,
+                                char **actual_dump,
+                                char **expected_dump)
+{
+    HexdumpRegion regions[NARWHAL_HEXDUMP_MAX_REGIONS];
+    bool truncated;
+    size_t region_count = hexdump_find_regions(
+        actual, expected, size, bytes_per_row, context_rows, regions, &truncated);
+
+    size_t differing_bytes =
+        narwhal_count_different_bytes((const char *)actual, (const char *)expected, size);
+
+    char header[32 + NARWHAL_HEXDUMP_MAX_REGIONS * 20];
+    size_t header_length = (size_t)snprintf(header,
+                                            sizeof(header),
+                                            "%zu differing byte%s at offset%s",
+                                            differing_bytes,
+                                            differing_bytes == 1 ? "" : "s",
+                                            region_count == 1 ? "" : "s");
+
+    for (size_t i = 0; i < region_count; i++)
+    {
+        header_length += (size_t)snprintf(header + header_length,
+                                          sizeof(header) - header_length,
+                                          "%s%06zX",
+                                          i == 0 ? " " : ", ",
+                                          regions[i].mismatch);
+    }
+
+    if (truncated)
+    {
+        snprintf(header + header_length, sizeof(header) - header_length, ", ...");
+    }
+
+    *actual_dump = hexdump_write_regions(
+        actual, size, bytes_per_row, header, regions, region_count, truncated);
+    *expected_dump = hexdump_write_regions(
+        expected, size, bytes_per_row, header, regions, region_count, truncated);
+}
+
 size_t narwhal_optimal_bytes_per_row(size_t element_size, size_t target, size_t range)
 {
     size_t min = target - range;
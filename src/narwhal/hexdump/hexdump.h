@@ -4,7 +4,16 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#define NARWHAL_HEXDUMP_MAX_REGIONS 16
+
 char *narwhal_hexdump(const uint8_t *buffer, size_t size, size_t bytes_per_row);
+void narwhal_hexdump_mismatches(const uint8_t *actual,
+                                const uint8_t *expected,
+                                size_t size,
+                                size_t bytes_per_row,
+                                size_t context_rows,
+                                char **actual_dump,
+                                char **expected_dump);
 size_t narwhal_optimal_bytes_per_row(size_t element_size, size_t target, size_t range);
 
 #endif
@@ -8,12 +8,26 @@
 
 int narwhal_run_tests(NarwhalGroupItemRegistration *tests, size_t test_count)
 {
+    return narwhal_run_tests_with_options(&_narwhal_default_options, NULL, tests, test_count);
+}
+
+int narwhal_run_tests_with_options(const NarwhalOptions *options,
+                                   NarwhalTestSession *test_session,
+                                   NarwhalGroupItemRegistration *tests,
+                                   size_t test_count)
+{
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = options;
+
     NarwhalTestGroup *root_group = narwhal_new_test_group("root", tests, test_count);
 
-    int status = narwhal_run_root_group(root_group);
+    int status = test_session != NULL ? narwhal_run_root_group_in_session(test_session, root_group)
+                                      : narwhal_run_root_group(root_group);
 
     narwhal_free_test_group(root_group);
 
+    _narwhal_current_options = previous_options;
+
     return status;
 }
 
@@ -21,13 +35,76 @@ int narwhal_run_root_group(NarwhalTestGroup *root_group)
 {
     NarwhalTestSession *test_session = narwhal_new_test_session();
 
-    narwhal_test_session_start(test_session);
+    int status = narwhal_run_root_group_in_session(test_session, root_group);
+
+    narwhal_free_test_session(test_session);
+
+    return status;
+}
+
+int narwhal_run_root_group_in_session(NarwhalTestSession *test_session,
+                                      NarwhalTestGroup *root_group)
+{
+    if (!narwhal_test_session_start(test_session))
+    {
+        return EXIT_FAILURE;
+    }
+
     narwhal_test_session_run_test_group(test_session, root_group, root_group->only);
     narwhal_test_session_end(test_session);
 
-    int status = test_session->failures->count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    return test_session->failure_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-    narwhal_free_test_session(test_session);
+/*
+ * Command-line entry point
+ */
+
+int narwhal_main(int argc, char *argv[])
+{
+    NarwhalOptions *options = narwhal_new_options();
+
+    if (!narwhal_parse_options(options, argc, argv))
+    {
+        narwhal_free_options(options);
+        return EXIT_FAILURE;
+    }
+
+    if (options->help)
+    {
+        narwhal_output_usage(stdout, argc > 0 ? argv[0] : "run_tests");
+        narwhal_free_options(options);
+        return EXIT_SUCCESS;
+    }
+
+    if (options->show_output != NULL)
+    {
+        bool found = narwhal_output_log_show(stdout, options->output_log, options->show_output);
+        narwhal_free_options(options);
+        return found ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = options;
+
+    NarwhalTestGroup *root_group = narwhal_discover_tests();
+
+    int status = EXIT_SUCCESS;
+
+    if (options->list)
+    {
+        narwhal_output_test_list(stdout, root_group, options->list_format);
+    }
+    else
+    {
+        status = narwhal_run_root_group(root_group);
+    }
+
+    narwhal_free_test_group(root_group);
+
+    _narwhal_current_options = previous_options;
+
+    narwhal_free_options(options);
 
     return status;
 }
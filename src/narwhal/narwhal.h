@@ -1,27 +1,48 @@
 #ifndef NARWHAL_H
 #define NARWHAL_H
 
+#include "narwhal/arena/arena.h"
 #include "narwhal/assertion/assertion.h"
 #include "narwhal/collection/collection.h"
+#include "narwhal/combination/combination.h"
+#include "narwhal/compression/compression.h"
 #include "narwhal/diff/diff.h"
 #include "narwhal/discovery/discovery.h"
 #include "narwhal/fixture/fixture.h"
 #include "narwhal/group/group.h"
 #include "narwhal/hexdump/hexdump.h"
+#include "narwhal/options/options.h"
 #include "narwhal/output/output.h"
+#include "narwhal/output_log/output_log.h"
 #include "narwhal/param/param.h"
+#include "narwhal/reporter/reporter.h"
 #include "narwhal/result/result.h"
+#include "narwhal/selector/selector.h"
 #include "narwhal/session/session.h"
 #include "narwhal/test/test.h"
 #include "narwhal/test_utils/test_utils.h"
 #include "narwhal/types.h"
 
 int narwhal_run_tests(NarwhalGroupItemRegistration *tests, size_t test_count);
+int narwhal_run_tests_with_options(const NarwhalOptions *options,
+                                   NarwhalTestSession *test_session,
+                                   NarwhalGroupItemRegistration *tests,
+                                   size_t test_count);
 int narwhal_run_root_group(NarwhalTestGroup *root_group);
+int narwhal_run_root_group_in_session(NarwhalTestSession *test_session,
+                                      NarwhalTestGroup *root_group);
+int narwhal_main(int argc, char *argv[]);
 
 #define RUN_TESTS(...)                                                          \
     narwhal_run_tests((NarwhalGroupItemRegistration[]){ __VA_ARGS__ },          \
                       sizeof((NarwhalGroupItemRegistration[]){ __VA_ARGS__ }) / \
                           sizeof(NarwhalGroupItemRegistration))
 
+#define RUN_TESTS_WITH_OPTIONS(options, test_session, ...)                                   \
+    narwhal_run_tests_with_options(options,                                                  \
+                                   test_session,                                             \
+                                   (NarwhalGroupItemRegistration[]){ __VA_ARGS__ },          \
+                                   sizeof((NarwhalGroupItemRegistration[]){ __VA_ARGS__ }) / \
+                                       sizeof(NarwhalGroupItemRegistration))
+
 #endif
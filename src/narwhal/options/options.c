@@ -0,0 +1,346 @@
+#include "narwhal/options/options.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "narwhal/collection/collection.h"
+#include "narwhal/reporter/reporter.h"
+#include "narwhal/selector/selector.h"
+
+/*
+ * Default and current options
+ */
+
+const NarwhalOptions _narwhal_default_options = { .help = false,
+                                                  .regex = false,
+                                                  .list = false,
+                                                  .list_format = NARWHAL_LIST_FORMAT_TEXT,
+                                                  .seed = 0,
+                                                  .diff_algorithm = NARWHAL_DIFF_ALGORITHM_MYERS,
+                                                  .diff_limits = { .max_size = 16777216,
+                                                                   .max_edits = 10000,
+                                                                   .max_milliseconds = 1000 },
+                                                  .hexdump_context = 4,
+                                                  .output_limits = { .enabled = false,
+                                                                     .head_size = 0,
+                                                                     .tail_size = 0 },
+                                                  .output_log = NULL,
+                                                  .show_output = NULL,
+                                                  .report_file = NULL,
+                                                  .streaming = false,
+                                                  .kept_failures = SIZE_MAX,
+                                                  .patterns = NULL,
+                                                  .selectors = NULL,
+                                                  .reporters = NULL };
+
+const NarwhalOptions *_narwhal_current_options = &_narwhal_default_options;
+
+/*
+ * Options initialization
+ */
+
+static unsigned long long random_seed(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    unsigned long long seed = (unsigned long long)now.tv_sec * 1000000 +
+                              (unsigned long long)now.tv_usec;
+
+    return (seed ^ ((unsigned long long)getpid() << 32)) % 1000000000;
+}
+
+static void initialize_options(NarwhalOptions *options)
+{
+    *options = _narwhal_default_options;
+    options->seed = random_seed();
+    options->patterns = narwhal_empty_collection();
+    options->selectors = narwhal_empty_collection();
+    options->reporters = narwhal_empty_collection();
+}
+
+NarwhalOptions *narwhal_new_options(void)
+{
+    NarwhalOptions *options = malloc(sizeof(NarwhalOptions));
+    initialize_options(options);
+
+    return options;
+}
+
+/*
+ * Parse command-line arguments
+ */
+
+static bool compile_selectors(NarwhalOptions *options)
+{
+    const char *pattern;
+    NARWHAL_EACH(pattern, options->patterns)
+    {
+        NarwhalTestSelector *selector = narwhal_new_test_selector(pattern, options->regex);
+
+        if (selector == NULL)
+        {
+            return false;
+        }
+
+        narwhal_collection_append(options->selectors, selector);
+    }
+
+    return true;
+}
+
+static bool parse_number(const char *value, const char *name, unsigned long long *number)
+{
+    char *end = NULL;
+    errno = 0;
+    *number = strtoull(value, &end, 10);
+
+    // strtoull skips whitespace and negates values with a leading minus sign
+    if (value[0] < '0' || value[0] > '9' || *end != '\0' || errno == ERANGE)
+    {
+        fprintf(stderr, "Invalid %s \"%s\".\n", name, value);
+        return false;
+    }
+
+    return true;
+}
+
+static bool parse_size(const char *value, const char *name, size_t *size)
+{
+    unsigned long long number;
+
+    if (!parse_number(value, name, &number))
+    {
+        return false;
+    }
+
+    if (number > SIZE_MAX)
+    {
+        fprintf(stderr, "Invalid %s \"%s\".\n", name, value);
+        return false;
+    }
+
+    *size = (size_t)number;
+    return true;
+}
+
+bool narwhal_parse_options(NarwhalOptions *options, int argc, char *argv[])
+{
+    bool only_patterns = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        char *argument = argv[i];
+
+        if (only_patterns || argument[0] != '-' || argument[1] == '\0')
+        {
+            narwhal_collection_append(options->patterns, argument);
+        }
+        else if (strcmp(argument, "--") == 0)
+        {
+            only_patterns = true;
+        }
+        else if (strcmp(argument, "-h") == 0 || strcmp(argument, "--help") == 0)
+        {
+            options->help = true;
+        }
+        else if (strcmp(argument, "-E") == 0 || strcmp(argument, "--regex") == 0)
+        {
+            options->regex = true;
+        }
+        else if (strcmp(argument, "--list") == 0 || strcmp(argument, "--list=text") == 0)
+        {
+            options->list = true;
+            options->list_format = NARWHAL_LIST_FORMAT_TEXT;
+        }
+        else if (strcmp(argument, "--list=json") == 0)
+        {
+            options->list = true;
+            options->list_format = NARWHAL_LIST_FORMAT_JSON;
+        }
+        else if (strncmp(argument, "--seed=", 7) == 0)
+        {
+            if (!parse_number(argument + 7, "seed", &options->seed))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argument, "--diff-algorithm=myers") == 0)
+        {
+            options->diff_algorithm = NARWHAL_DIFF_ALGORITHM_MYERS;
+        }
+        else if (strcmp(argument, "--diff-algorithm=patience") == 0)
+        {
+            options->diff_algorithm = NARWHAL_DIFF_ALGORITHM_PATIENCE;
+        }
+        else if (strncmp(argument, "--diff-max-size=", 16) == 0)
+        {
+            if (!parse_size(argument + 16, "diff size", &options->diff_limits.max_size))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--diff-max-edits=", 17) == 0)
+        {
+            if (!parse_size(argument + 17, "diff edits", &options->diff_limits.max_edits))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--diff-timeout=", 15) == 0)
+        {
+            if (!parse_size(
+                    argument + 15, "diff timeout", &options->diff_limits.max_milliseconds))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--hexdump-context=", 18) == 0)
+        {
+            if (!parse_size(argument + 18, "hexdump context", &options->hexdump_context))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--output-head=", 14) == 0)
+        {
+            options->output_limits.enabled = true;
+
+            if (!parse_size(argument + 14, "output head", &options->output_limits.head_size))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--output-tail=", 14) == 0)
+        {
+            options->output_limits.enabled = true;
+
+            if (!parse_size(argument + 14, "output tail", &options->output_limits.tail_size))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--output-log=", 13) == 0)
+        {
+            options->output_log = argument + 13;
+        }
+        else if (strncmp(argument, "--show-output=", 14) == 0)
+        {
+            options->show_output = argument + 14;
+        }
+        else if (strncmp(argument, "--reporter=", 11) == 0)
+        {
+            NarwhalReporterConfig *reporter_config = narwhal_parse_reporter_config(argument + 11);
+
+            if (reporter_config == NULL)
+            {
+                return false;
+            }
+
+            narwhal_collection_append(options->reporters, reporter_config);
+        }
+        else if (strcmp(argument, "--streaming") == 0)
+        {
+            options->streaming = true;
+        }
+        else if (strncmp(argument, "--streaming=", 12) == 0)
+        {
+            options->streaming = true;
+
+            if (!parse_size(argument + 12, "kept failures", &options->kept_failures))
+            {
+                return false;
+            }
+        }
+        else if (strncmp(argument, "--report-file=", 14) == 0)
+        {
+            options->report_file = argument + 14;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option \"%s\". Run with --help for usage.\n", argument);
+            return false;
+        }
+    }
+
+    if (options->show_output != NULL && options->output_log == NULL)
+    {
+        fprintf(stderr, "The --show-output option requires --output-log.\n");
+        return false;
+    }
+
+    return compile_selectors(options);
+}
+
+void narwhal_output_usage(FILE *stream, const char *program)
+{
+    fprintf(stream, "Usage: %s [options] [pattern...]\n", program);
+    fprintf(stream, "\n");
+    fprintf(stream, "Only run the tests whose full name, or the name of one of their groups,\n");
+    fprintf(stream, "matches one of the given patterns. Full names look like group/test.\n");
+    fprintf(stream, "\n");
+    fprintf(stream, "Options:\n");
+    fprintf(stream, "  -E, --regex           Treat patterns as extended regular expressions\n");
+    fprintf(stream, "  --list[=FORMAT]       List the selected test instances without running\n");
+    fprintf(stream, "                        them, FORMAT is either text (default) or json\n");
+    fprintf(stream, "  --seed=SEED           Seed used for sampling parameter combinations\n");
+    fprintf(stream, "  --diff-algorithm=NAME Line diff algorithm, either myers (default) or\n");
+    fprintf(stream, "                        patience\n");
+    fprintf(stream, "  --diff-max-size=BYTES Only diff failing outputs up to this size\n");
+    fprintf(stream, "  --diff-max-edits=N    Give up on diffs with more than N edits\n");
+    fprintf(stream, "  --diff-timeout=MS     Give up on diffs that take longer than MS\n");
+    fprintf(stream, "                        milliseconds, 0 disables any of these limits\n");
+    fprintf(stream, "  --hexdump-context=ROWS\n");
+    fprintf(stream, "                        Rows shown around each mismatch in memory\n");
+    fprintf(stream, "                        assertions (default 4)\n");
+    fprintf(stream, "  --output-head=BYTES   Only keep the beginning and the end of the output\n");
+    fprintf(stream, "  --output-tail=BYTES   of each test, the bytes in between are elided\n");
+    fprintf(stream, "  --output-log=FILE     Save the output of every test to FILE, indexed in\n");
+    fprintf(stream, "                        FILE.index, instead of dropping the output of\n");
+    fprintf(stream, "                        passing tests\n");
+    fprintf(stream, "  --show-output=ID      Print the output logged for ID in the output log\n");
+    fprintf(stream, "                        instead of running the tests\n");
+    fprintf(stream, "  --report-file=FILE    Write the test report to FILE instead of stdout\n");
+    fprintf(stream, "  --streaming[=FAILURES]\n");
+    fprintf(stream, "                        Release passing results as soon as they are\n");
+    fprintf(stream, "                        reported, and keep at most FAILURES failures\n");
+    fprintf(stream, "  --reporter=FORMAT[:FILE]\n");
+    fprintf(stream, "                        Report results as text (default), junit, jsonl or\n");
+    fprintf(stream, "                        tap, to FILE or to the report, can be repeated\n");
+    fprintf(stream, "  -h, --help            Display this message\n");
+}
+
+/*
+ * Cleanup
+ */
+
+void narwhal_free_options(NarwhalOptions *options)
+{
+    while (options->reporters->count > 0)
+    {
+        NarwhalReporterConfig *reporter_config = narwhal_collection_pop(options->reporters);
+        narwhal_free_reporter_config(reporter_config);
+    }
+    narwhal_free_collection(options->reporters);
+
+    while (options->selectors->count > 0)
+    {
+        NarwhalTestSelector *selector = narwhal_collection_pop(options->selectors);
+        narwhal_free_test_selector(selector);
+    }
+    narwhal_free_collection(options->selectors);
+
+    while (options->patterns->count > 0)
+    {
+        narwhal_collection_pop(options->patterns);
+    }
+    narwhal_free_collection(options->patterns);
+
+    free(options);
+}
@@ -0,0 +1,46 @@
+#ifndef NARWHAL_OPTIONS_H
+#define NARWHAL_OPTIONS_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "narwhal/diff/diff.h"
+#include "narwhal/result/result.h"
+#include "narwhal/types.h"
+
+extern const NarwhalOptions _narwhal_default_options;
+extern const NarwhalOptions *_narwhal_current_options;
+
+enum NarwhalListFormat
+{
+    NARWHAL_LIST_FORMAT_TEXT,
+    NARWHAL_LIST_FORMAT_JSON
+};
+
+struct NarwhalOptions
+{
+    bool help;
+    bool regex;
+    bool list;
+    NarwhalListFormat list_format;
+    unsigned long long seed;
+    NarwhalDiffAlgorithm diff_algorithm;
+    NarwhalDiffLimits diff_limits;
+    size_t hexdump_context;
+    NarwhalOutputLimits output_limits;
+    const char *output_log;
+    const char *show_output;
+    const char *report_file;
+    bool streaming;
+    size_t kept_failures;
+    NarwhalCollection *patterns;
+    NarwhalCollection *selectors;
+    NarwhalCollection *reporters;
+};
+
+NarwhalOptions *narwhal_new_options(void);
+bool narwhal_parse_options(NarwhalOptions *options, int argc, char *argv[]);
+void narwhal_output_usage(FILE *stream, const char *program);
+void narwhal_free_options(NarwhalOptions *options);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef NARWHAL_OPTIONS_TYPES_H
+#define NARWHAL_OPTIONS_TYPES_H
+
+typedef struct NarwhalOptions NarwhalOptions;
+typedef enum NarwhalListFormat NarwhalListFormat;
+
+#endif
@@ -1,13 +1,19 @@
 #include "narwhal/output/output.h"
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 #include "narwhal/collection/collection.h"
+#include "narwhal/combination/combination.h"
 #include "narwhal/diff/diff.h"
 #include "narwhal/group/group.h"
+#include "narwhal/options/options.h"
 #include "narwhal/output/ansi.h"
 #include "narwhal/param/param.h"
 #include "narwhal/result/result.h"
@@ -96,20 +102,20 @@ static double elapsed_milliseconds(struct timeval start_time, struct timeval end
  * Display result list
  */
 
-static void display_test_result(const NarwhalTestResult *test_result)
+static void display_test_result(FILE *stream, const NarwhalTestResult *test_result)
 {
-    printf(INDENT);
+    fprintf(stream, INDENT);
 
     char full_name[256];
     full_test_name(test_result->test, full_name, sizeof(full_name));
 
     if (test_result->success)
     {
-        printf(COLOR_BOLD(GREEN, "PASS") " %s", full_name);
+        fprintf(stream, COLOR_BOLD(GREEN, "PASS") " %s", full_name);
     }
     else
     {
-        printf(COLOR_BOLD(RED, "FAIL") " " BOLD("%s"), full_name);
+        fprintf(stream, COLOR_BOLD(RED, "FAIL") " " BOLD("%s"), full_name);
     }
 
     if (test_result->param_snapshots->count > 0)
@@ -117,29 +123,30 @@ static void display_test_result(const NarwhalTestResult *test_result)
         char snapshot_string[256];
         get_param_snapshots(
             test_result->param_snapshots->first, snapshot_string, sizeof(snapshot_string));
-        printf(" " COLOR_BOLD(BLUE, "with"));
-        printf(" %s", snapshot_string);
+        fprintf(stream, " " COLOR_BOLD(BLUE, "with"));
+        fprintf(stream, " %s", snapshot_string);
     }
 
-    printf(" (" COLOR_BOLD(YELLOW, "%.2fms") ")",
-           elapsed_milliseconds(test_result->start_time, test_result->end_time));
+    fprintf(stream,
+            " (" COLOR_BOLD(YELLOW, "%.2fms") ")",
+            elapsed_milliseconds(test_result->start_time, test_result->end_time));
 
-    printf("\n");
+    fprintf(stream, "\n");
 }
 
-static void display_results(const NarwhalTestSession *test_session)
+static void display_results(FILE *stream, const NarwhalTestSession *test_session)
 {
-    printf("\nTest results:\n\n");
+    fprintf(stream, "\nTest results:\n\n");
 
     NarwhalTestResult *test_result;
-    NARWHAL_EACH(test_result, test_session->results) { display_test_result(test_result); }
+    NARWHAL_EACH(test_result, test_session->results) { display_test_result(stream, test_result); }
 }
 
 /*
  * Display failures
  */
 
-static void display_assertion(const char *filename, size_t assertion_line)
+static void display_assertion(FILE *stream, const char *filename, size_t assertion_line)
 {
     FILE *file = fopen(filename, "r");
 
@@ -148,7 +155,7 @@ static void display_assertion(const char *filename, size_t assertion_line)
         return;
     }
 
-    printf("\n");
+    fprintf(stream, "\n");
 
     char line[256];
     size_t line_number = 0;
@@ -174,25 +181,26 @@ static void display_assertion(const char *filename, size_t assertion_line)
             char line_prefix[64];
             snprintf(
                 line_prefix, sizeof(line_prefix), "> " COLOR_BOLD(MAGENTA, "%ld"), line_number);
-            printf("    %23s", line_prefix);
-            printf(" |  " COLOR_BOLD(CYAN, "%s"), line);
+            fprintf(stream, "    %23s", line_prefix);
+            fprintf(stream, " |  " COLOR_BOLD(CYAN, "%s"), line);
         }
         else
         {
-            printf("    " COLOR(MAGENTA, "%6zu"), line_number);
-            printf(" |  %s", line);
+            fprintf(stream, "    " COLOR(MAGENTA, "%6zu"), line_number);
+            fprintf(stream, " |  %s", line);
         }
     }
 
     if (!not_last_line && line[strlen(line) - 1] != '\n')
     {
-        printf("\n");
+        fprintf(stream, "\n");
     }
 
     fclose(file);
 }
 
-static const char *display_inline_diff(const NarwhalDiff *inline_diff,
+static const char *display_inline_diff(FILE *stream,
+                                       const NarwhalDiff *inline_diff,
                                        size_t lines,
                                        const char *string,
                                        size_t *line_number,
@@ -216,7 +224,7 @@ static const char *display_inline_diff(const NarwhalDiff *inline_diff,
                      sizeof(line_prefix),
                      COLOR(RED, "- ") COLOR_BOLD(RED, "%ld"),
                      *line_number);
-            printf("   %37s" COLOR(RED, " |  "), line_prefix);
+            fprintf(stream, "   %37s" COLOR(RED, " |  "), line_prefix);
         }
         else
         {
@@ -224,7 +232,7 @@ static const char *display_inline_diff(const NarwhalDiff *inline_diff,
                      sizeof(line_prefix),
                      COLOR(GREEN, "+ ") COLOR_BOLD(GREEN, "%ld"),
                      *line_number);
-            printf("   %37s" COLOR(GREEN, " |  "), line_prefix);
+            fprintf(stream, "   %37s" COLOR(GREEN, " |  "), line_prefix);
         }
 
         while (index - line_index < line_length)
@@ -239,18 +247,23 @@ static const char *display_inline_diff(const NarwhalDiff *inline_diff,
 
             if (inline_chunk->type == NARWHAL_DIFF_CHUNK_TYPE_MATCHED)
             {
-                printf("%.*s", (int)characters, string + index - line_index);
+                fprintf(stream, "%.*s", (int)characters, string + index - line_index);
             }
             else if (characters > 0)
             {
                 if (use_original)
                 {
-                    printf(COLOR_BOLD(RED, "%.*s"), (int)characters, string + index - line_index);
+                    fprintf(stream,
+                            COLOR_BOLD(RED, "%.*s"),
+                            (int)characters,
+                            string + index - line_index);
                 }
                 else
                 {
-                    printf(
-                        COLOR_BOLD(GREEN, "%.*s"), (int)characters, string + index - line_index);
+                    fprintf(stream,
+                            COLOR_BOLD(GREEN, "%.*s"),
+                            (int)characters,
+                            string + index - line_index);
                 }
             }
 
@@ -262,7 +275,7 @@ static const char *display_inline_diff(const NarwhalDiff *inline_diff,
             }
         }
 
-        printf("\n");
+        fprintf(stream, "\n");
 
         if (!use_original)
         {
@@ -277,11 +290,223 @@ static const char *display_inline_diff(const NarwhalDiff *inline_diff,
     return string;
 }
 
-static void display_diff(const char *original, const char *modified)
+static int summary_line_length(size_t length)
 {
-    printf(INDENT INDENT "Diff:\n\n");
+    return (int)narwhal_min_size_t(length, NARWHAL_DIFF_SUMMARY_WIDTH);
+}
+
+static const char *summary_line_ellipsis(size_t length)
+{
+    return length > NARWHAL_DIFF_SUMMARY_WIDTH ? "..." : "";
+}
+
+static void display_summary_lines(FILE *stream,
+                                  const char *string,
+                                  size_t line_number,
+                                  bool use_original)
+{
+    for (size_t i = 0; i <= NARWHAL_DIFF_SUMMARY_CONTEXT; i++)
+    {
+        const char *next = narwhal_next_line(string);
+        size_t line_length = (size_t)(next - string);
+
+        char line_prefix[64];
+
+        if (use_original)
+        {
+            snprintf(line_prefix,
+                     sizeof(line_prefix),
+                     COLOR(RED, "- ") COLOR_BOLD(RED, "%ld"),
+                     line_number + i);
+            fprintf(stream, "   %37s", line_prefix);
+            fprintf(stream,
+                    COLOR(RED, " |  ") COLOR_BOLD(RED, "%.*s%s\n"),
+                    summary_line_length(line_length),
+                    string,
+                    summary_line_ellipsis(line_length));
+        }
+        else
+        {
+            snprintf(line_prefix,
+                     sizeof(line_prefix),
+                     COLOR(GREEN, "+ ") COLOR_BOLD(GREEN, "%ld"),
+                     line_number + i);
+            fprintf(stream, "   %37s", line_prefix);
+            fprintf(stream,
+                    COLOR(GREEN, " |  ") COLOR_BOLD(GREEN, "%.*s%s\n"),
+                    summary_line_length(line_length),
+                    string,
+                    summary_line_ellipsis(line_length));
+        }
+
+        if (*next == '\0')
+        {
+            break;
+        }
+
+        string = next + 1;
+    }
+}
+
+static void display_diff_summary(FILE *stream,
+                                 const char *original,
+                                 const char *modified,
+                                 NarwhalDiffLimit exceeded_limit,
+                                 const NarwhalDiffLimits *limits)
+{
+    if (exceeded_limit == NARWHAL_DIFF_LIMIT_SIZE)
+    {
+        fprintf(stream,
+                INDENT INDENT "The diff was skipped because the outputs are larger than %zu "
+                              "bytes.\n",
+                limits->max_size);
+    }
+    else if (exceeded_limit == NARWHAL_DIFF_LIMIT_EDITS)
+    {
+        fprintf(stream,
+                INDENT INDENT "The diff was skipped because the outputs differ by more than %zu "
+                              "edits.\n",
+                limits->max_edits);
+    }
+    else
+    {
+        fprintf(stream,
+                INDENT INDENT "The diff was skipped because it took longer than %zu ms.\n",
+                limits->max_milliseconds);
+    }
+
+    size_t original_size = strlen(original);
+    size_t modified_size = strlen(modified);
+
+    fprintf(stream, "\n");
+    fprintf(stream,
+            INDENT INDENT "Original: %zu bytes, %zu lines, hash %016" PRIx64 "\n",
+            original_size,
+            narwhal_count_bytes(original, original_size, '\n') + 1,
+            narwhal_hash_bytes(original, original_size));
+    fprintf(stream,
+            INDENT INDENT "Modified: %zu bytes, %zu lines, hash %016" PRIx64 "\n",
+            modified_size,
+            narwhal_count_bytes(modified, modified_size, '\n') + 1,
+            narwhal_hash_bytes(modified, modified_size));
+
+    size_t offset = narwhal_common_prefix_length(
+        original, modified, narwhal_min_size_t(original_size, modified_size));
+
+    const char *line = original + offset;
+
+    while (line > original && line[-1] != '\n')
+    {
+        line--;
+    }
+
+    size_t line_number = narwhal_count_bytes(original, (size_t)(line - original), '\n') + 1;
+
+    fprintf(stream, "\n");
+    fprintf(stream,
+            INDENT INDENT "First difference at byte %zu, line %zu:\n\n",
+            offset,
+            line_number);
+
+    const char *context = line;
+    size_t context_lines = 0;
+
+    while (context > original && context_lines < NARWHAL_DIFF_SUMMARY_CONTEXT)
+    {
+        context--;
+
+        while (context > original && context[-1] != '\n')
+        {
+            context--;
+        }
+
+        context_lines++;
+    }
+
+    for (size_t i = 0; i < context_lines; i++)
+    {
+        const char *next = narwhal_next_line(context);
+        size_t line_length = (size_t)(next - context);
+
+        fprintf(stream, INDENT COLOR(MAGENTA, "%6zu"), line_number - context_lines + i);
+        fprintf(stream,
+                " |  %.*s%s\n",
+                summary_line_length(line_length),
+                context,
+                summary_line_ellipsis(line_length));
+
+        context = next + 1;
+    }
+
+    display_summary_lines(stream, line, line_number, true);
+    display_summary_lines(stream, modified + (line - original), line_number, false);
+}
+
+static NarwhalDiff inline_diff_within_limits(const char *original,
+                                             size_t original_length,
+                                             const char *modified,
+                                             size_t modified_length,
+                                             const NarwhalDiffLimits *limits,
+                                             struct timeval start_time)
+{
+    NarwhalDiffLimits inline_limits = *limits;
+    bool expired = false;
+
+    if (limits->max_milliseconds > 0)
+    {
+        struct timeval now;
+        gettimeofday(&now, NULL);
 
-    NarwhalDiff diff = narwhal_diff_lines(original, modified);
+        double remaining =
+            (double)limits->max_milliseconds - elapsed_milliseconds(start_time, now);
+
+        expired = remaining < 1;
+        inline_limits.max_milliseconds = expired ? 0 : (size_t)remaining;
+    }
+
+    NarwhalDiff inline_diff;
+
+    if (!expired && narwhal_diff_strings_limited(original,
+                                                 original_length,
+                                                 modified,
+                                                 modified_length,
+                                                 NARWHAL_DIFF_ALGORITHM_BIT_PARALLEL,
+                                                 &inline_limits,
+                                                 &inline_diff) == NARWHAL_DIFF_LIMIT_NONE)
+    {
+        return inline_diff;
+    }
+
+    inline_diff.size = 1;
+    inline_diff.chunks = malloc(sizeof(NarwhalDiffChunk));
+
+    inline_diff.chunks[0].type = NARWHAL_DIFF_CHUNK_TYPE_REPLACED;
+    inline_diff.chunks[0].original_start = 0;
+    inline_diff.chunks[0].original_end = original_length;
+    inline_diff.chunks[0].modified_start = 0;
+    inline_diff.chunks[0].modified_end = modified_length;
+
+    return inline_diff;
+}
+
+void narwhal_output_diff(FILE *stream, const char *original, const char *modified)
+{
+    fprintf(stream, INDENT INDENT "Diff:\n\n");
+
+    const NarwhalDiffLimits *limits = &_narwhal_current_options->diff_limits;
+
+    struct timeval start_time;
+    gettimeofday(&start_time, NULL);
+
+    NarwhalDiff diff;
+    NarwhalDiffLimit exceeded_limit = narwhal_diff_lines_limited(
+        original, modified, _narwhal_current_options->diff_algorithm, limits, &diff);
+
+    if (exceeded_limit != NARWHAL_DIFF_LIMIT_NONE)
+    {
+        display_diff_summary(stream, original, modified, exceeded_limit, limits);
+        return;
+    }
 
     size_t line_number = 1;
 
@@ -302,12 +527,12 @@ static void display_diff(const char *original, const char *modified)
                 if (original_lines < 7 || (i < 2 && chunk_index > 0) ||
                     (original_lines - i < 3 && chunk_index < diff.size - 1))
                 {
-                    printf(INDENT COLOR(MAGENTA, "%6zu"), line_number);
-                    printf(" |  %.*s\n", (int)(original_next - original), original);
+                    fprintf(stream, INDENT COLOR(MAGENTA, "%6zu"), line_number);
+                    fprintf(stream, " |  %.*s\n", (int)(original_next - original), original);
                 }
                 else if (i == 2)
                 {
-                    printf(INDENT INDENT "   :\n");
+                    fprintf(stream, INDENT INDENT "   :\n");
                 }
 
                 line_number++;
@@ -323,13 +548,15 @@ static void display_diff(const char *original, const char *modified)
             size_t original_length = (size_t)(original_end - original);
             size_t modified_length = (size_t)(modified_end - modified);
 
-            NarwhalDiff inline_diff =
-                narwhal_diff_strings_lengths(original, original_length, modified, modified_length);
+            NarwhalDiff inline_diff = inline_diff_within_limits(
+                original, original_length, modified, modified_length, limits, start_time);
 
             original =
-                display_inline_diff(&inline_diff, original_lines, original, &line_number, true);
+                display_inline_diff(
+                    stream, &inline_diff, original_lines, original, &line_number, true);
             modified =
-                display_inline_diff(&inline_diff, modified_lines, modified, &line_number, false);
+                display_inline_diff(
+                    stream, &inline_diff, modified_lines, modified, &line_number, false);
 
             free(inline_diff.chunks);
         }
@@ -345,10 +572,11 @@ static void display_diff(const char *original, const char *modified)
                          COLOR(RED, "- ") COLOR_BOLD(RED, "%ld"),
                          line_number);
 
-                printf("   %37s", line_prefix);
-                printf(COLOR(RED, " |  ") COLOR_BOLD(RED, "%.*s\n"),
-                       (int)(original_next - original),
-                       original);
+                fprintf(stream, "   %37s", line_prefix);
+                fprintf(stream,
+                        COLOR(RED, " |  ") COLOR_BOLD(RED, "%.*s\n"),
+                        (int)(original_next - original),
+                        original);
 
                 original = original_next + 1;
             }
@@ -365,10 +593,11 @@ static void display_diff(const char *original, const char *modified)
                          COLOR(GREEN, "+ ") COLOR_BOLD(GREEN, "%ld"),
                          line_number);
 
-                printf("   %37s", line_prefix);
-                printf(COLOR(GREEN, " |  ") COLOR_BOLD(GREEN, "%.*s\n"),
-                       (int)(modified_next - modified),
-                       modified);
+                fprintf(stream, "   %37s", line_prefix);
+                fprintf(stream,
+                        COLOR(GREEN, " |  ") COLOR_BOLD(GREEN, "%.*s\n"),
+                        (int)(modified_next - modified),
+                        modified);
 
                 line_number++;
                 modified = modified_next + 1;
@@ -379,127 +608,158 @@ static void display_diff(const char *original, const char *modified)
     free(diff.chunks);
 }
 
-static void display_output(const char *output)
+static void display_output(FILE *stream, const char *output)
 {
-    printf(INDENT INDENT "Output:\n\n");
+    fprintf(stream, INDENT INDENT "Output:\n\n");
 
-    narwhal_output_string(stdout, output, 1, INDENT);
+    narwhal_output_string(stream, output, 1, INDENT);
 }
 
-static void display_failure(const NarwhalTestResult *test_result)
+static void display_failure(FILE *stream, const NarwhalTestResult *test_result)
 {
     NarwhalTest *test = test_result->test;
 
     char full_name[256];
     full_test_name(test, full_name, sizeof(full_name));
 
-    printf("\n" INDENT BOLD("%s"), full_name);
+    fprintf(stream, "\n" INDENT BOLD("%s"), full_name);
 
     if (test_result->param_snapshots->count > 0)
     {
         char snapshot_string[256];
         get_param_snapshots(
             test_result->param_snapshots->first, snapshot_string, sizeof(snapshot_string));
-        printf(" " COLOR_BOLD(BLUE, "with"));
-        printf(" %s", snapshot_string);
+        fprintf(stream, " " COLOR_BOLD(BLUE, "with"));
+        fprintf(stream, " %s", snapshot_string);
     }
 
-    printf(" failed:\n");
+    fprintf(stream, " failed:\n");
+
+    fprintf(stream, "\n" INDENT INDENT "ID:       " ANSI_RESET ANSI_COLOR_MAGENTA);
+    narwhal_output_test_result_id(stream, test_result);
+    fprintf(stream, ANSI_RESET "\n");
 
-    printf("\n" INDENT INDENT "Location: " COLOR(GREEN, "%s:%zu") "\n",
-           test_result->assertion_file,
-           test_result->assertion_line);
-    printf(INDENT INDENT "Time:     " COLOR_BOLD(YELLOW, "%.2fms") "\n",
-           elapsed_milliseconds(test_result->start_time, test_result->end_time));
-    printf(INDENT INDENT "Error:    ");
+    fprintf(stream,
+            INDENT INDENT "Location: " COLOR(GREEN, "%s:%zu") "\n",
+            test_result->assertion_file,
+            test_result->assertion_line);
+    fprintf(stream,
+            INDENT INDENT "Time:     " COLOR_BOLD(YELLOW, "%.2fms") "\n",
+            elapsed_milliseconds(test_result->start_time, test_result->end_time));
+    fprintf(stream, INDENT INDENT "Error:    ");
 
     if (test_result->failed_assertion != NULL)
     {
-        printf(COLOR_BOLD(RED, "Assertion"));
+        fprintf(stream, COLOR_BOLD(RED, "Assertion"));
 
         if (narwhal_is_short_string(test_result->failed_assertion))
         {
-            printf(" " COLOR_BOLD(CYAN, "%s"), test_result->failed_assertion);
+            fprintf(stream, " " COLOR_BOLD(CYAN, "%s"), test_result->failed_assertion);
         }
 
-        printf(COLOR_BOLD(RED, " failed."));
-        printf("\n" INDENT INDENT INDENT INDENT "  ");
+        fprintf(stream, COLOR_BOLD(RED, " failed."));
+        fprintf(stream, "\n" INDENT INDENT INDENT INDENT "  ");
     }
 
     bool has_diff = narwhal_test_result_has_diff(test_result);
 
     if (has_diff)
     {
-        printf(COLOR_BOLD(RED, "%s"), "See diff for details.");
+        fprintf(stream, COLOR_BOLD(RED, "%s"), "See diff for details.");
     }
     else if (test_result->timed_out)
     {
-        printf(COLOR_BOLD(RED, "Test process took longer than %ldms to complete."),
-               test_result->test->timeout);
+        fprintf(stream,
+                COLOR_BOLD(RED, "Test process took longer than %ldms to complete."),
+                test_result->test->timeout);
     }
     else if (strlen(test_result->error_message) > 0)
     {
-        printf(COLOR_BOLD(RED, "%s"), test_result->error_message);
+        fprintf(stream, COLOR_BOLD(RED, "%s"), test_result->error_message);
     }
     else
     {
-        printf(COLOR_BOLD(RED, "%s"), "No details available.");
+        fprintf(stream, COLOR_BOLD(RED, "%s"), "No details available.");
     }
 
-    printf("\n");
+    fprintf(stream, "\n");
 
     if (test_result->assertion_line != test->line_number ||
         strcmp(test_result->assertion_file, test->filename) != 0)
     {
-        display_assertion(test_result->assertion_file, test_result->assertion_line);
+        display_assertion(stream, test_result->assertion_file, test_result->assertion_line);
     }
 
     if (has_diff)
     {
-        printf("\n");
-        display_diff(test_result->diff_original, test_result->diff_modified);
+        fprintf(stream, "\n");
+        narwhal_output_diff(stream, test_result->diff_original, test_result->diff_modified);
     }
 
     if (test_result->output_length > 0)
     {
-        printf("\n");
-        display_output(test_result->output_buffer);
+        fprintf(stream, "\n");
+        display_output(stream, test_result->output_buffer);
     }
 }
 
-static void display_failing_tests(const NarwhalTestSession *test_session)
+static void display_failing_tests(FILE *stream, const NarwhalTestSession *test_session)
 {
-    printf("\nFailing tests:\n");
+    fprintf(stream, "\nFailing tests:\n");
 
     NarwhalTestResult *test_result;
-    NARWHAL_EACH(test_result, test_session->failures) { display_failure(test_result); }
+    NARWHAL_EACH(test_result, test_session->failures)
+    {
+        narwhal_decompress_test_result(test_result);
+        display_failure(stream, test_result);
+        narwhal_compress_test_result(test_result);
+    }
+
+    size_t dropped_failures = test_session->failure_count - test_session->failures->count;
+
+    if (dropped_failures > 0)
+    {
+        fprintf(stream,
+                "\n" INDENT "%zu more failing test%s not shown.\n",
+                dropped_failures,
+                dropped_failures == 1 ? " is" : "s are");
+    }
 }
 
 /*
  * Display session summary
  */
 
-static void display_session_summary(const NarwhalTestSession *test_session)
+static void display_session_summary(FILE *stream, const NarwhalTestSession *test_session)
 {
-    printf("\nTests: ");
+    fprintf(stream, "\nTests: ");
 
-    if (test_session->failures->count > 0)
+    if (test_session->failure_count > 0)
     {
-        printf(COLOR_BOLD(RED, "%zu failed") ", ", test_session->failures->count);
+        fprintf(stream, COLOR_BOLD(RED, "%zu failed") ", ", test_session->failure_count);
     }
-    printf(COLOR_BOLD(GREEN, "%zu passed") ", ",
-           test_session->results->count - test_session->failures->count);
-    printf("%zu total\n", test_session->results->count);
+    fprintf(stream,
+            COLOR_BOLD(GREEN, "%zu passed") ", ",
+            test_session->result_count - test_session->failure_count);
+    fprintf(stream, "%zu total\n", test_session->result_count);
 
-    printf("Time:  " COLOR_BOLD(YELLOW, "%.2fms") "\n",
-           elapsed_milliseconds(test_session->start_time, test_session->end_time));
+    fprintf(stream,
+            "Time:  " COLOR_BOLD(YELLOW, "%.2fms") "\n",
+            elapsed_milliseconds(test_session->start_time, test_session->end_time));
+
+    if (test_session->sampled)
+    {
+        fprintf(stream,
+                "Seed:  " COLOR_BOLD(MAGENTA, "%llu") "\n",
+                _narwhal_current_options->seed);
+    }
 }
 
 /*
  * Progress utils
  */
 
-static void display_dot_string(const NarwhalSessionOutputState *output_state)
+static void display_dot_string(FILE *stream, const NarwhalSessionOutputState *output_state)
 {
     char string_label[64];
 
@@ -508,14 +768,213 @@ static void display_dot_string(const NarwhalSessionOutputState *output_state)
              COLOR(MAGENTA, "%d") " - " COLOR(MAGENTA, "%d"),
              output_state->index,
              output_state->index + output_state->length - 1);
-    printf("%36s |  ", string_label);
+    fprintf(stream, "%36s |  ", string_label);
 
     for (int i = 0; i < output_state->length; i++)
     {
-        printf(output_state->string[i] == '.' ? "." : COLOR_BOLD(RED, "F"));
+        fputs(output_state->string[i] == '.' ? "." : COLOR_BOLD(RED, "F"), stream);
+    }
+}
+
+static void refresh_dot_string(FILE *stream, NarwhalSessionOutputState *output_state, bool force)
+{
+    if (output_state->displayed_length == output_state->length)
+    {
+        return;
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    // Redrawing the line for every test would flush the report after each of them
+    if (!force &&
+        elapsed_milliseconds(output_state->refresh_time, now) < NARWHAL_PROGRESS_REFRESH_INTERVAL)
+    {
+        return;
+    }
+
+    if (output_state->displayed_length > 0)
+    {
+        fprintf(stream, "\r");
+    }
+
+    display_dot_string(stream, output_state);
+    fflush(stream);
+
+    output_state->displayed_length = output_state->length;
+    output_state->refresh_time = now;
+}
+
+/*
+ * JSON strings
+ */
+
+static void output_json_characters(FILE *stream, const char *string)
+{
+    for (const char *chr = string; *chr != '\0'; chr++)
+    {
+        switch (*chr)
+        {
+            case '"':
+                fputs("\\\"", stream);
+                break;
+            case '\\':
+                fputs("\\\\", stream);
+                break;
+            case '\n':
+                fputs("\\n", stream);
+                break;
+            case '\r':
+                fputs("\\r", stream);
+                break;
+            case '\t':
+                fputs("\\t", stream);
+                break;
+            default:
+                if ((unsigned char)*chr < 0x20)
+                {
+                    fprintf(stream, "\\u%04x", (unsigned int)*chr);
+                }
+                else
+                {
+                    fputc(*chr, stream);
+                }
+        }
+    }
+}
+
+/*
+ * Test list
+ */
+
+static void list_json_test_id(FILE *stream, const NarwhalTest *test, bool with_params)
+{
+    if (test->group != NULL && test->group->full_name != NULL)
+    {
+        output_json_characters(stream, test->group->full_name);
+        fputc('/', stream);
+    }
+
+    output_json_characters(stream, test->name);
+
+    if (!with_params || test->params->count == 0)
+    {
+        return;
+    }
+
+    char separator = '[';
+
+    NarwhalTestParam *test_param;
+    NARWHAL_EACH(test_param, test->params)
+    {
+        fputc(separator, stream);
+        output_json_characters(stream, test_param->name);
+        fprintf(stream, "=%zu", test_param->index);
+        separator = ',';
+    }
+
+    fputc(']', stream);
+}
+
+static void list_test_instance(FILE *stream,
+                               const NarwhalTest *test,
+                               bool sampled,
+                               NarwhalListFormat format,
+                               size_t *instance_count)
+{
+    if (format == NARWHAL_LIST_FORMAT_TEXT)
+    {
+        if (sampled)
+        {
+            narwhal_output_test_full_name(stream, test);
+        }
+        else
+        {
+            narwhal_output_test_id(stream, test);
+        }
+
+        fputc('\n', stream);
+    }
+    else
+    {
+        fprintf(stream, "%s\n  {\"id\": \"", *instance_count > 0 ? "," : "");
+        list_json_test_id(stream, test, !sampled);
+        fprintf(stream, "\", \"name\": \"");
+        list_json_test_id(stream, test, false);
+        fprintf(stream, "\", \"file\": ");
+        narwhal_output_json_string(stream, test->filename);
+        fprintf(stream, ", \"line\": %zu, \"params\": {", test->line_number);
+
+        if (sampled)
+        {
+            fprintf(stream, "}, \"sampled\": true}");
+            (*instance_count)++;
+            return;
+        }
+
+        const char *separator = "";
+
+        NarwhalTestParam *test_param;
+        NARWHAL_EACH(test_param, test->params)
+        {
+            fputs(separator, stream);
+            narwhal_output_json_string(stream, test_param->name);
+            fprintf(stream, ": %zu", test_param->index);
+            separator = ", ";
+        }
+
+        fprintf(stream, "}}");
+    }
+
+    (*instance_count)++;
+}
+
+static void list_parameterized_test(FILE *stream,
+                                    NarwhalTest *test,
+                                    NarwhalListFormat format,
+                                    size_t *instance_count)
+{
+    NarwhalParamCombinations *combinations = narwhal_new_param_combinations(test);
+
+    // The instances of a time-boxed sample depend on the clock, so only the test is listed
+    if (combinations->budget > 0)
+    {
+        list_test_instance(stream, test, true, format, instance_count);
+    }
+
+    while (combinations->budget == 0 && narwhal_param_combinations_next(combinations))
+    {
+        list_test_instance(stream, test, false, format, instance_count);
+    }
+
+    narwhal_free_param_combinations(combinations);
+}
+
+static void list_test_group(FILE *stream,
+                            NarwhalTestGroup *test_group,
+                            bool only,
+                            NarwhalListFormat format,
+                            size_t *instance_count)
+{
+    narwhal_materialize_test_group(test_group);
+
+    NarwhalTestGroup *subgroup;
+    NARWHAL_EACH(subgroup, test_group->subgroups)
+    {
+        if (!only || subgroup->only)
+        {
+            list_test_group(stream, subgroup, only, format, instance_count);
+        }
     }
 
-    fflush(stdout);
+    NarwhalTest *test;
+    NARWHAL_EACH(test, test_group->tests)
+    {
+        if (!test->skip && (!only || test->only))
+        {
+            list_parameterized_test(stream, test, format, instance_count);
+        }
+    }
 }
 
 /*
@@ -562,53 +1021,210 @@ void narwhal_output_string(FILE *stream,
     fprintf(stream, "%s\n", line);
 }
 
-void narwhal_output_session_init(NarwhalTestSession *test_session)
+void narwhal_output_json_string(FILE *stream, const char *string)
 {
-    printf("\nRunning tests...\n");
+    fputc('"', stream);
+    output_json_characters(stream, string);
+    fputc('"', stream);
+}
 
-    NarwhalSessionOutputState *output_state = &test_session->output_state;
+void narwhal_output_xml_string(FILE *stream, const char *string)
+{
+    for (const char *chr = string; *chr != '\0'; chr++)
+    {
+        switch (*chr)
+        {
+            case '&':
+                fputs("&amp;", stream);
+                break;
+            case '<':
+                fputs("&lt;", stream);
+                break;
+            case '>':
+                fputs("&gt;", stream);
+                break;
+            case '"':
+                fputs("&quot;", stream);
+                break;
+            case '\n':
+            case '\r':
+            case '\t':
+                fputc(*chr, stream);
+                break;
+            default:
+                // Other control characters can't appear in XML 1.0 documents, even escaped
+                if ((unsigned char)*chr < 0x20)
+                {
+                    fputs("&#xFFFD;", stream);
+                }
+                else
+                {
+                    fputc(*chr, stream);
+                }
+        }
+    }
+}
 
-    output_state->length = sizeof(output_state->string);
-    output_state->index = -output_state->length + 1;
+void narwhal_output_test_full_name(FILE *stream, const NarwhalTest *test)
+{
+    if (test->group != NULL && test->group->full_name != NULL)
+    {
+        fprintf(stream, "%s/", test->group->full_name);
+    }
+
+    fputs(test->name, stream);
 }
 
-void narwhal_output_session_progress(NarwhalTestSession *test_session)
+void narwhal_output_test_id(FILE *stream, const NarwhalTest *test)
 {
-    NarwhalSessionOutputState *output_state = &test_session->output_state;
-    const NarwhalTestResult *last_result = test_session->results->last->value;
+    narwhal_output_test_full_name(stream, test);
 
-    if (output_state->length < (int)sizeof(output_state->string))
+    if (test->params->count == 0)
     {
-        output_state->string[output_state->length] = last_result->success ? '.' : 'F';
-        output_state->length++;
+        return;
+    }
 
-        printf("\r");
-        display_dot_string(&test_session->output_state);
+    char separator = '[';
+
+    NarwhalTestParam *test_param;
+    NARWHAL_EACH(test_param, test->params)
+    {
+        fprintf(stream, "%c%s=%zu", separator, test_param->name, test_param->index);
+        separator = ',';
     }
-    else
+
+    fputc(']', stream);
+}
+
+void narwhal_output_test_result_id(FILE *stream, const NarwhalTestResult *test_result)
+{
+    narwhal_output_test_full_name(stream, test_result->test);
+
+    if (test_result->param_snapshots->count == 0)
+    {
+        return;
+    }
+
+    char separator = '[';
+
+    NarwhalTestParamSnapshot *param_snapshot;
+    NARWHAL_EACH(param_snapshot, test_result->param_snapshots)
     {
+        fprintf(stream, "%c%s=%zu", separator, param_snapshot->param->name, param_snapshot->index);
+        separator = ',';
+    }
+
+    fputc(']', stream);
+}
+
+FILE *narwhal_open_report_stream(int fd)
+{
+    int report_fd = dup(fd);
+
+    if (report_fd == -1)
+    {
+        return NULL;
+    }
+
+    FILE *stream = fdopen(report_fd, "w");
+
+    if (stream == NULL)
+    {
+        close(report_fd);
+        return NULL;
+    }
+
+    setvbuf(stream, NULL, _IOFBF, NARWHAL_REPORT_BUFFER_SIZE);
+
+    return stream;
+}
+
+FILE *narwhal_open_report_file(const char *filename)
+{
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Couldn't open the report file \"%s\".\n", filename);
+        return NULL;
+    }
+
+    FILE *stream = narwhal_open_report_stream(fd);
+    close(fd);
+
+    return stream;
+}
+
+void narwhal_output_session_init(FILE *stream, NarwhalSessionOutputState *output_state)
+{
+    fprintf(stream, "\nRunning tests...\n");
+
+    output_state->length = sizeof(output_state->string);
+    output_state->displayed_length = output_state->length;
+    output_state->index = -output_state->length + 1;
+    output_state->refresh_time = (struct timeval){ 0, 0 };
+}
+
+void narwhal_output_session_progress(FILE *stream,
+                                     NarwhalSessionOutputState *output_state,
+                                     const NarwhalTestResult *test_result)
+{
+    if (output_state->length == (int)sizeof(output_state->string))
+    {
+        refresh_dot_string(stream, output_state, true);
+        fprintf(stream, "\n");
+
         output_state->index += (int)sizeof(output_state->string);
-        output_state->length = 1;
+        output_state->length = 0;
+        output_state->displayed_length = 0;
+    }
+
+    output_state->string[output_state->length] = test_result->success ? '.' : 'F';
+    output_state->length++;
+
+    refresh_dot_string(stream, output_state, false);
+}
+
+void narwhal_output_test_list(FILE *stream,
+                              NarwhalTestGroup *root_group,
+                              NarwhalListFormat format)
+{
+    size_t instance_count = 0;
 
-        output_state->string[0] = last_result->success ? '.' : 'F';
+    if (format == NARWHAL_LIST_FORMAT_JSON)
+    {
+        fputc('[', stream);
+    }
 
-        printf("\n");
-        display_dot_string(&test_session->output_state);
+    list_test_group(stream, root_group, root_group->only, format, &instance_count);
+
+    if (format == NARWHAL_LIST_FORMAT_JSON)
+    {
+        fprintf(stream, instance_count > 0 ? "\n]\n" : "]\n");
     }
 }
 
-void narwhal_output_session_result(const NarwhalTestSession *test_session)
+void narwhal_output_session_result(FILE *stream,
+                                   NarwhalSessionOutputState *output_state,
+                                   const NarwhalTestSession *test_session)
 {
+    refresh_dot_string(stream, output_state, true);
+
+    // Streaming sessions may not keep any result, the progress line still needs to be separated
+    if (test_session->result_count > 0)
+    {
+        fprintf(stream, "\n");
+    }
+
     if (test_session->results->count > 0)
     {
-        printf("\n");
-        display_results(test_session);
+        display_results(stream, test_session);
     }
 
-    if (test_session->failures->count > 0)
+    if (test_session->failure_count > 0)
     {
-        display_failing_tests(test_session);
+        display_failing_tests(stream, test_session);
     }
 
-    display_session_summary(test_session);
+    display_session_summary(stream, test_session);
 }
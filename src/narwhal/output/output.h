@@ -5,13 +5,35 @@
 
 #include "narwhal/types.h"
 
+#define NARWHAL_DIFF_SUMMARY_CONTEXT 2
+#define NARWHAL_DIFF_SUMMARY_WIDTH 120
+#define NARWHAL_REPORT_BUFFER_SIZE (1 << 16)
+#define NARWHAL_PROGRESS_REFRESH_INTERVAL 50
+
 void narwhal_output_string(FILE *stream,
                            const char *string,
                            size_t line_number,
                            const char *indent);
 
-void narwhal_output_session_init(NarwhalTestSession *test_session);
-void narwhal_output_session_progress(NarwhalTestSession *test_session);
-void narwhal_output_session_result(const NarwhalTestSession *test_session);
+void narwhal_output_diff(FILE *stream, const char *original, const char *modified);
+void narwhal_output_json_string(FILE *stream, const char *string);
+void narwhal_output_xml_string(FILE *stream, const char *string);
+void narwhal_output_test_full_name(FILE *stream, const NarwhalTest *test);
+void narwhal_output_test_id(FILE *stream, const NarwhalTest *test);
+void narwhal_output_test_result_id(FILE *stream, const NarwhalTestResult *test_result);
+void narwhal_output_test_list(FILE *stream,
+                              NarwhalTestGroup *root_group,
+                              NarwhalListFormat format);
+
+FILE *narwhal_open_report_stream(int fd);
+FILE *narwhal_open_report_file(const char *filename);
+
+void narwhal_output_session_init(FILE *stream, NarwhalSessionOutputState *output_state);
+void narwhal_output_session_progress(FILE *stream,
+                                     NarwhalSessionOutputState *output_state,
+                                     const NarwhalTestResult *test_result);
+void narwhal_output_session_result(FILE *stream,
+                                   NarwhalSessionOutputState *output_state,
+                                   const NarwhalTestSession *test_session);
 
 #endif
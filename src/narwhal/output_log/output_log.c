@@ -0,0 +1,203 @@
+#include "narwhal/output_log/output_log.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "narwhal/output/output.h"
+#include "narwhal/result/result.h"
+
+#define OUTPUT_LOG_CHUNK_SIZE 65536
+
+/*
+ * Open output log
+ */
+
+static FILE *open_index(const char *path, const char *mode)
+{
+    size_t path_length = strlen(path);
+    char *index_path = malloc(path_length + sizeof(NARWHAL_OUTPUT_LOG_INDEX_SUFFIX));
+
+    memcpy(index_path, path, path_length);
+    memcpy(index_path + path_length,
+           NARWHAL_OUTPUT_LOG_INDEX_SUFFIX,
+           sizeof(NARWHAL_OUTPUT_LOG_INDEX_SUFFIX));
+
+    FILE *index = fopen(index_path, mode);
+
+    free(index_path);
+
+    return index;
+}
+
+NarwhalOutputLog *narwhal_open_output_log(const char *path)
+{
+    FILE *data = fopen(path, "w");
+    FILE *index = data != NULL ? open_index(path, "w") : NULL;
+
+    if (index == NULL)
+    {
+        fprintf(stderr, "Couldn't open output log \"%s\".\n", path);
+
+        if (data != NULL)
+        {
+            fclose(data);
+        }
+
+        return NULL;
+    }
+
+    NarwhalOutputLog *output_log = malloc(sizeof(NarwhalOutputLog));
+    output_log->data = data;
+    output_log->index = index;
+    output_log->size = 0;
+
+    return output_log;
+}
+
+/*
+ * Append test output
+ */
+
+void narwhal_output_log_append(NarwhalOutputLog *output_log, const NarwhalTestResult *test_result)
+{
+    struct stat file_stat;
+
+    if (test_result->output_file == -1 || fstat(test_result->output_file, &file_stat) == -1)
+    {
+        return;
+    }
+
+    size_t offset = output_log->size;
+    size_t length = 0;
+
+    char chunk[OUTPUT_LOG_CHUNK_SIZE];
+
+    while (length < (size_t)file_stat.st_size)
+    {
+        ssize_t bytes_read = pread(test_result->output_file, chunk, sizeof(chunk), (off_t)length);
+
+        if (bytes_read <= 0)
+        {
+            break;
+        }
+
+        fwrite(chunk, 1, (size_t)bytes_read, output_log->data);
+        length += (size_t)bytes_read;
+    }
+
+    output_log->size += length;
+
+    fprintf(output_log->index, "%zu\t%zu\t", offset, length);
+    narwhal_output_test_result_id(output_log->index, test_result);
+    fputc('\n', output_log->index);
+
+    // Forked test processes would otherwise flush the buffered data again when they exit
+    fflush(output_log->data);
+    fflush(output_log->index);
+}
+
+/*
+ * Show logged output
+ */
+
+static bool matches_test_id(const char *logged_id, const char *test_id)
+{
+    size_t length = strlen(test_id);
+
+    return strncmp(logged_id, test_id, length) == 0 &&
+           (logged_id[length] == '\0' || logged_id[length] == '[');
+}
+
+static void copy_range(FILE *stream, FILE *data, size_t offset, size_t length)
+{
+    char chunk[OUTPUT_LOG_CHUNK_SIZE];
+
+    if (fseeko(data, (off_t)offset, SEEK_SET) == -1)
+    {
+        return;
+    }
+
+    while (length > 0)
+    {
+        size_t count = fread(chunk, 1, length < sizeof(chunk) ? length : sizeof(chunk), data);
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        fwrite(chunk, 1, count, stream);
+        length -= count;
+    }
+}
+
+bool narwhal_output_log_show(FILE *stream, const char *path, const char *test_id)
+{
+    FILE *data = fopen(path, "r");
+    FILE *index = data != NULL ? open_index(path, "r") : NULL;
+
+    if (index == NULL)
+    {
+        fprintf(stderr, "Couldn't open output log \"%s\".\n", path);
+
+        if (data != NULL)
+        {
+            fclose(data);
+        }
+
+        return false;
+    }
+
+    bool found = false;
+
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t line_length;
+
+    while ((line_length = getline(&line, &line_size, index)) != -1)
+    {
+        if (line_length > 0 && line[line_length - 1] == '\n')
+        {
+            line[line_length - 1] = '\0';
+        }
+
+        size_t offset;
+        size_t length;
+        int id_start = 0;
+
+        if (sscanf(line, "%zu\t%zu\t%n", &offset, &length, &id_start) != 2 || id_start == 0 ||
+            !matches_test_id(line + id_start, test_id))
+        {
+            continue;
+        }
+
+        found = true;
+        copy_range(stream, data, offset, length);
+    }
+
+    free(line);
+    fclose(index);
+    fclose(data);
+
+    if (!found)
+    {
+        fprintf(stderr, "No output logged for \"%s\".\n", test_id);
+    }
+
+    return found;
+}
+
+/*
+ * Cleanup
+ */
+
+void narwhal_close_output_log(NarwhalOutputLog *output_log)
+{
+    fclose(output_log->data);
+    fclose(output_log->index);
+    free(output_log);
+}
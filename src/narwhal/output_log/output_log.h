@@ -0,0 +1,23 @@
+#ifndef NARWHAL_OUTPUT_LOG_H
+#define NARWHAL_OUTPUT_LOG_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "narwhal/types.h"
+
+#define NARWHAL_OUTPUT_LOG_INDEX_SUFFIX ".index"
+
+struct NarwhalOutputLog
+{
+    FILE *data;
+    FILE *index;
+    size_t size;
+};
+
+NarwhalOutputLog *narwhal_open_output_log(const char *path);
+void narwhal_output_log_append(NarwhalOutputLog *output_log, const NarwhalTestResult *test_result);
+bool narwhal_output_log_show(FILE *stream, const char *path, const char *test_id);
+void narwhal_close_output_log(NarwhalOutputLog *output_log);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef NARWHAL_OUTPUT_LOG_TYPES_H
+#define NARWHAL_OUTPUT_LOG_TYPES_H
+
+typedef struct NarwhalOutputLog NarwhalOutputLog;
+
+#endif
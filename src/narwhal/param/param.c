@@ -1,9 +1,16 @@
 #include "narwhal/param/param.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "narwhal/collection/collection.h"
+#include "narwhal/utils.h"
 
 /*
  * Currently accessible params
@@ -25,6 +32,7 @@ static void initialize_test_param(NarwhalTestParam *test_param,
     test_param->index = 0;
     test_param->count = count;
     test_param->values = values;
+    test_param->error = NULL;
     test_param->test = test;
 }
 
@@ -56,6 +64,177 @@ NarwhalTestParam *narwhal_get_test_param(const NarwhalCollection *params, const
     return NULL;
 }
 
+/*
+ * File-backed params
+ */
+
+static bool map_param_file(NarwhalParamFile *param_file, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat file_stat;
+
+    if (fstat(fd, &file_stat) == -1)
+    {
+        close(fd);
+        return false;
+    }
+
+    param_file->size = (size_t)file_stat.st_size;
+
+    if (param_file->size > 0)
+    {
+        param_file->data = mmap(NULL, param_file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    int mmap_errno = errno;
+    close(fd);
+    errno = mmap_errno;
+
+    if (param_file->data == MAP_FAILED)
+    {
+        param_file->data = NULL;
+        param_file->size = 0;
+        return false;
+    }
+
+    return true;
+}
+
+static void index_param_lines(NarwhalParamFile *param_file)
+{
+    const char *data = param_file->data;
+    const char *end = data + param_file->size;
+
+    size_t line_count = narwhal_count_bytes(data, param_file->size, '\n');
+
+    if (param_file->size > 0 && end[-1] != '\n')
+    {
+        line_count++;
+    }
+
+    NarwhalParamLine *lines = malloc((line_count + 1) * sizeof(NarwhalParamLine));
+
+    for (size_t i = 0; i < line_count; i++)
+    {
+        const char *newline = memchr(data, '\n', (size_t)(end - data));
+        const char *line_end = newline != NULL ? newline : end;
+
+        lines[i].data = data;
+        lines[i].length = (size_t)(line_end - data);
+
+        if (lines[i].length > 0 && line_end[-1] == '\r')
+        {
+            lines[i].length--;
+        }
+
+        data = line_end + 1;
+    }
+
+    param_file->values = lines;
+    param_file->count = line_count;
+}
+
+static void resolve_param_file_path(const NarwhalParamFile *param_file,
+                                    char *path,
+                                    size_t path_size)
+{
+    const char *source_directory_end =
+        param_file->source_file != NULL ? strrchr(param_file->source_file, '/') : NULL;
+
+    if (param_file->path[0] == '/' || source_directory_end == NULL)
+    {
+        snprintf(path, path_size, "%s", param_file->path);
+        return;
+    }
+
+    snprintf(path,
+             path_size,
+             "%.*s/%s",
+             (int)(source_directory_end - param_file->source_file),
+             param_file->source_file,
+             param_file->path);
+}
+
+bool narwhal_load_param_file(NarwhalParamFile *param_file, const char *param_name)
+{
+    if (param_file->loaded)
+    {
+        return param_file->error[0] == '\0';
+    }
+
+    param_file->loaded = true;
+    param_file->error[0] = '\0';
+    param_file->data = NULL;
+    param_file->size = 0;
+    param_file->values = NULL;
+    param_file->count = 0;
+
+    char path[4096];
+    resolve_param_file_path(param_file, path, sizeof(path));
+
+    if (!map_param_file(param_file, path))
+    {
+        snprintf(param_file->error,
+                 sizeof(param_file->error),
+                 "Failed to load test parameter \"%s\" from \"%s\": %s.",
+                 param_name,
+                 path,
+                 strerror(errno));
+        return false;
+    }
+
+    if (param_file->record_size == 0)
+    {
+        index_param_lines(param_file);
+    }
+    else if (param_file->size % param_file->record_size != 0)
+    {
+        snprintf(param_file->error,
+                 sizeof(param_file->error),
+                 "Failed to load test parameter \"%s\" from \"%s\": "
+                 "The size of the file isn't a multiple of the record size (%zu bytes).",
+                 param_name,
+                 path,
+                 param_file->record_size);
+
+        munmap(param_file->data, param_file->size);
+        param_file->data = NULL;
+        param_file->size = 0;
+
+        return false;
+    }
+    else
+    {
+        param_file->values = param_file->data;
+        param_file->count = param_file->size / param_file->record_size;
+    }
+
+    return true;
+}
+
+void narwhal_register_test_param_file(NarwhalTest *test,
+                                      NarwhalCollection *access_collection,
+                                      const char *param_name,
+                                      NarwhalParamFile *param_file)
+{
+    if (narwhal_load_param_file(param_file, param_name))
+    {
+        narwhal_register_test_param(
+            test, access_collection, param_name, param_file->values, param_file->count);
+        return;
+    }
+
+    // A single value carrying the error makes the test fail instead of running zero times
+    narwhal_register_test_param(test, access_collection, param_name, NULL, 1);
+    narwhal_get_test_param(test->params, param_name)->error = param_file->error;
+}
+
 /*
  * Cleanup
  */
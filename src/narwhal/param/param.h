@@ -1,6 +1,7 @@
 #ifndef NARWHAL_PARAM_H
 #define NARWHAL_PARAM_H
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 #include "narwhal/test/test.h"
@@ -14,6 +15,7 @@ struct NarwhalTestParam
     size_t index;
     size_t count;
     const void *values;
+    const char *error;
     NarwhalTest *test;
 };
 
@@ -24,6 +26,31 @@ NarwhalTestParam *narwhal_new_test_param(const char *name,
 NarwhalTestParam *narwhal_get_test_param(const NarwhalCollection *params, const char *param_name);
 void narwhal_free_test_param(NarwhalTestParam *test_param);
 
+struct NarwhalParamFile
+{
+    const char *path;
+    const char *source_file;
+    size_t record_size;
+    bool loaded;
+    char error[4352];
+    void *data;
+    size_t size;
+    const void *values;
+    size_t count;
+};
+
+struct NarwhalParamLine
+{
+    const char *data;
+    size_t length;
+};
+
+bool narwhal_load_param_file(NarwhalParamFile *param_file, const char *param_name);
+void narwhal_register_test_param_file(NarwhalTest *test,
+                                      NarwhalCollection *access_collection,
+                                      const char *param_name,
+                                      NarwhalParamFile *param_file);
+
 #define DECLARE_PARAM(param_name, param_type)            \
     typedef param_type _narwhal_param_type_##param_name; \
     extern NarwhalTestModifierRegistration param_name;
@@ -45,6 +72,27 @@ void narwhal_free_test_param(NarwhalTestParam *test_param);
     }                                                                                          \
     NarwhalTestModifierRegistration param_name = { _narwhal_param_registration_##param_name, NULL }
 
+#define _NARWHAL_TEST_PARAM_FROM_FILE(param_name, param_type, file_path, file_record_size)     \
+    DECLARE_PARAM(param_name, param_type);                                                     \
+    static NarwhalParamFile _narwhal_param_file_##param_name = {                               \
+        .path = file_path, .source_file = __FILE__, .record_size = file_record_size            \
+    };                                                                                         \
+    void _narwhal_param_registration_##param_name(NarwhalTest *test,                           \
+                                                  NarwhalCollection *params,                   \
+                                                  _NARWHAL_UNUSED NarwhalCollection *fixtures, \
+                                                  _NARWHAL_UNUSED void *args)                  \
+    {                                                                                          \
+        narwhal_register_test_param_file(                                                      \
+            test, params, #param_name, &_narwhal_param_file_##param_name);                     \
+    }                                                                                          \
+    NarwhalTestModifierRegistration param_name = { _narwhal_param_registration_##param_name, NULL }
+
+#define TEST_PARAM_FROM_FILE(param_name, param_type, path) \
+    _NARWHAL_TEST_PARAM_FROM_FILE(param_name, param_type, path, sizeof(param_type))
+
+#define TEST_PARAM_FROM_LINES(param_name, path) \
+    _NARWHAL_TEST_PARAM_FROM_FILE(param_name, NarwhalParamLine, path, 0)
+
 #define GET_PARAM(param_name)                                                                  \
     _narwhal_param_type_##param_name param_name;                                               \
     do                                                                                         \
@@ -2,5 +2,7 @@
 #define NARWHAL_PARAM_TYPES_H
 
 typedef struct NarwhalTestParam NarwhalTestParam;
+typedef struct NarwhalParamFile NarwhalParamFile;
+typedef struct NarwhalParamLine NarwhalParamLine;
 
 #endif
@@ -0,0 +1,461 @@
+#include "narwhal/reporter/reporter.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "narwhal/collection/collection.h"
+#include "narwhal/group/group.h"
+#include "narwhal/options/options.h"
+#include "narwhal/output/output.h"
+#include "narwhal/param/param.h"
+#include "narwhal/result/result.h"
+#include "narwhal/test/test.h"
+#include "narwhal/utils.h"
+
+static const char *const reporter_format_names[] = { "text", "junit", "jsonl", "tap" };
+
+/*
+ * Reporter configuration
+ */
+
+NarwhalReporterConfig *narwhal_parse_reporter_config(const char *value)
+{
+    const char *separator = strchr(value, ':');
+    size_t name_length = separator != NULL ? (size_t)(separator - value) : strlen(value);
+
+    for (size_t i = 0; i < sizeof(reporter_format_names) / sizeof(*reporter_format_names); i++)
+    {
+        if (strlen(reporter_format_names[i]) == name_length &&
+            strncmp(reporter_format_names[i], value, name_length) == 0)
+        {
+            NarwhalReporterConfig *reporter_config = malloc(sizeof(NarwhalReporterConfig));
+            reporter_config->format = (NarwhalReporterFormat)i;
+            reporter_config->filename = separator != NULL ? separator + 1 : NULL;
+
+            return reporter_config;
+        }
+    }
+
+    fprintf(stderr,
+            "Invalid reporter \"%.*s\", expected text, junit, jsonl or tap.\n",
+            (int)name_length,
+            value);
+
+    return NULL;
+}
+
+void narwhal_free_reporter_config(NarwhalReporterConfig *reporter_config)
+{
+    free(reporter_config);
+}
+
+/*
+ * Initialize reporter
+ */
+
+static void initialize_reporter(NarwhalReporter *reporter,
+                                NarwhalReporterFormat format,
+                                FILE *stream,
+                                bool owns_stream)
+{
+    reporter->format = format;
+    reporter->stream = stream;
+    reporter->owns_stream = owns_stream;
+    reporter->pending = NULL;
+    reporter->count = 0;
+}
+
+NarwhalReporter *narwhal_new_reporter(NarwhalReporterFormat format,
+                                      FILE *stream,
+                                      bool owns_stream)
+{
+    NarwhalReporter *reporter = malloc(sizeof(NarwhalReporter));
+    initialize_reporter(reporter, format, stream, owns_stream);
+
+    return reporter;
+}
+
+/*
+ * Result details
+ */
+
+static double reporter_elapsed_milliseconds(struct timeval start_time, struct timeval end_time)
+{
+    return (double)(end_time.tv_sec - start_time.tv_sec) * 1000.0 +
+           (double)(end_time.tv_usec - start_time.tv_usec) / 1000.0;
+}
+
+static void reporter_failure_message(const NarwhalTestResult *test_result,
+                                     char *message,
+                                     size_t message_size)
+{
+    if (test_result->timed_out)
+    {
+        snprintf(message,
+                 message_size,
+                 "Test process took longer than %ldms to complete.",
+                 test_result->test->timeout);
+    }
+    else if (test_result->failed_assertion != NULL)
+    {
+        snprintf(message,
+                 message_size,
+                 "Assertion %s failed.",
+                 test_result->failed_assertion);
+    }
+    else if (test_result->error_message != NULL && strlen(test_result->error_message) > 0)
+    {
+        snprintf(message, message_size, "%s", test_result->error_message);
+    }
+    else
+    {
+        snprintf(message, message_size, "No details available.");
+    }
+}
+
+static void reporter_output_params(FILE *stream, const NarwhalTestResult *test_result)
+{
+    char separator = '[';
+
+    NarwhalTestParamSnapshot *param_snapshot;
+    NARWHAL_EACH(param_snapshot, test_result->param_snapshots)
+    {
+        fprintf(stream, "%c%s=%zu", separator, param_snapshot->param->name, param_snapshot->index);
+        separator = ',';
+    }
+
+    if (separator == ',')
+    {
+        fputc(']', stream);
+    }
+}
+
+/*
+ * JUnit XML
+ */
+
+static void junit_session_start(NarwhalReporter *reporter)
+{
+    fprintf(reporter->stream, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+
+    // The counts belong to the opening tag so test cases are held in a temporary file until the
+    // session ends, without keeping them in memory
+    reporter->pending = tmpfile();
+
+    if (reporter->pending == NULL)
+    {
+        fprintf(reporter->stream, "<testsuite name=\"narwhal\">\n");
+    }
+}
+
+static void junit_classname(FILE *stream, const NarwhalTest *test)
+{
+    if (test->group != NULL && test->group->full_name != NULL)
+    {
+        narwhal_output_xml_string(stream, test->group->full_name);
+        return;
+    }
+
+    const char *basename = strrchr(test->filename, '/');
+    basename = basename != NULL ? basename + 1 : test->filename;
+
+    const char *extension = strrchr(basename, '.');
+    size_t length = extension != NULL ? (size_t)(extension - basename) : strlen(basename);
+
+    char classname[256];
+    snprintf(classname, sizeof(classname), "%.*s", (int)length, basename);
+
+    narwhal_output_xml_string(stream, classname);
+}
+
+static void junit_test_result(FILE *stream, const NarwhalTestResult *test_result)
+{
+    const NarwhalTest *test = test_result->test;
+
+    fprintf(stream, "  <testcase classname=\"");
+    junit_classname(stream, test);
+
+    fprintf(stream, "\" name=\"%s", test->name);
+    reporter_output_params(stream, test_result);
+    fprintf(stream, "\" file=\"");
+    narwhal_output_xml_string(stream, test->filename);
+    fprintf(stream,
+            "\" line=\"%zu\" time=\"%.6f\"",
+            test->line_number,
+            reporter_elapsed_milliseconds(test_result->start_time, test_result->end_time) /
+                1000.0);
+
+    if (test_result->success)
+    {
+        fprintf(stream, "/>\n");
+        return;
+    }
+
+    char message[512];
+    reporter_failure_message(test_result, message, sizeof(message));
+
+    fprintf(stream, ">\n    <failure message=\"");
+    narwhal_output_xml_string(stream, message);
+    fprintf(stream, "\">");
+    narwhal_output_xml_string(stream, test_result->assertion_file);
+    fprintf(stream, ":%zu</failure>\n", test_result->assertion_line);
+
+    if (test_result->output_length > 0)
+    {
+        fprintf(stream, "    <system-out>");
+        narwhal_output_xml_string(stream, test_result->output_buffer);
+        fprintf(stream, "</system-out>\n");
+    }
+
+    fprintf(stream, "  </testcase>\n");
+}
+
+static void junit_session_end(NarwhalReporter *reporter, const NarwhalTestSession *test_session)
+{
+    if (reporter->pending != NULL)
+    {
+        fprintf(reporter->stream,
+                "<testsuite name=\"narwhal\" tests=\"%zu\" failures=\"%zu\" errors=\"0\" "
+                "time=\"%.6f\">\n",
+                test_session->result_count,
+                test_session->failure_count,
+                reporter_elapsed_milliseconds(test_session->start_time, test_session->end_time) /
+                    1000.0);
+
+        rewind(reporter->pending);
+
+        char buffer[8192];
+        size_t size;
+
+        while ((size = fread(buffer, 1, sizeof(buffer), reporter->pending)) > 0)
+        {
+            fwrite(buffer, 1, size, reporter->stream);
+        }
+
+        fclose(reporter->pending);
+        reporter->pending = NULL;
+    }
+
+    fprintf(reporter->stream, "</testsuite>\n");
+}
+
+/*
+ * JSON Lines
+ */
+
+static void json_lines_test_result(FILE *stream, const NarwhalTestResult *test_result)
+{
+    const NarwhalTest *test = test_result->test;
+
+    fprintf(stream, "{\"event\": \"result\", \"id\": \"");
+    narwhal_output_test_result_id(stream, test_result);
+    fprintf(stream, "\", \"name\": \"");
+    narwhal_output_test_full_name(stream, test);
+    fprintf(stream, "\", \"file\": ");
+    narwhal_output_json_string(stream, test->filename);
+    fprintf(stream,
+            ", \"line\": %zu, \"success\": %s, \"time\": %.3f",
+            test->line_number,
+            test_result->success ? "true" : "false",
+            reporter_elapsed_milliseconds(test_result->start_time, test_result->end_time));
+
+    if (!test_result->success)
+    {
+        char message[512];
+        reporter_failure_message(test_result, message, sizeof(message));
+
+        fprintf(stream, ", \"message\": ");
+        narwhal_output_json_string(stream, message);
+        fprintf(stream, ", \"location\": {\"file\": ");
+        narwhal_output_json_string(stream, test_result->assertion_file);
+        fprintf(stream, ", \"line\": %zu}", test_result->assertion_line);
+
+        if (test_result->output_length > 0)
+        {
+            fprintf(stream, ", \"output\": ");
+            narwhal_output_json_string(stream, test_result->output_buffer);
+            fprintf(stream, ", \"output_elided\": %zu", test_result->output_elided);
+        }
+    }
+
+    fprintf(stream, "}\n");
+}
+
+static void json_lines_session_end(FILE *stream, const NarwhalTestSession *test_session)
+{
+    fprintf(stream,
+            "{\"event\": \"summary\", \"passed\": %zu, \"failed\": %zu, \"total\": %zu, "
+            "\"time\": %.3f",
+            test_session->result_count - test_session->failure_count,
+            test_session->failure_count,
+            test_session->result_count,
+            reporter_elapsed_milliseconds(test_session->start_time, test_session->end_time));
+
+    if (test_session->sampled)
+    {
+        fprintf(stream, ", \"seed\": %llu", _narwhal_current_options->seed);
+    }
+
+    fprintf(stream, "}\n");
+}
+
+/*
+ * Test Anything Protocol
+ */
+
+static void tap_output_block(FILE *stream, const char *string)
+{
+    const char *line = string;
+
+    while (*line != '\0')
+    {
+        const char *line_end = narwhal_next_line(line);
+
+        fputs("    ", stream);
+
+        for (const char *chr = line; chr < line_end; chr++)
+        {
+            // YAML block scalars can only hold printable characters, even without escaping
+            if (*chr != '\t' && ((unsigned char)*chr < 0x20 || *chr == 0x7f))
+            {
+                fputs("\xef\xbf\xbd", stream);
+            }
+            else
+            {
+                fputc(*chr, stream);
+            }
+        }
+
+        fputc('\n', stream);
+        line = *line_end == '\0' ? line_end : line_end + 1;
+    }
+}
+
+static void tap_test_result(FILE *stream, size_t count, const NarwhalTestResult *test_result)
+{
+    fprintf(stream, "%sok %zu - ", test_result->success ? "" : "not ", count);
+    narwhal_output_test_result_id(stream, test_result);
+    fputc('\n', stream);
+
+    if (test_result->success)
+    {
+        return;
+    }
+
+    char message[512];
+    reporter_failure_message(test_result, message, sizeof(message));
+
+    fprintf(stream, "  ---\n  message: ");
+    narwhal_output_json_string(stream, message);
+    fprintf(stream, "\n  at: ");
+    narwhal_output_json_string(stream, test_result->assertion_file);
+    fprintf(stream,
+            "\n  line: %zu\n  time: %.3f\n",
+            test_result->assertion_line,
+            reporter_elapsed_milliseconds(test_result->start_time, test_result->end_time));
+
+    if (test_result->output_length > 0)
+    {
+        fprintf(stream, "  output: |\n");
+        tap_output_block(stream, test_result->output_buffer);
+    }
+
+    fprintf(stream, "  ...\n");
+}
+
+/*
+ * Reporter hooks
+ */
+
+void narwhal_reporter_session_start(NarwhalReporter *reporter,
+                                    const NarwhalTestSession *test_session)
+{
+    (void)test_session;
+
+    switch (reporter->format)
+    {
+        case NARWHAL_REPORTER_FORMAT_TEXT:
+            narwhal_output_session_init(reporter->stream, &reporter->output_state);
+            break;
+        case NARWHAL_REPORTER_FORMAT_JUNIT:
+            junit_session_start(reporter);
+            break;
+        case NARWHAL_REPORTER_FORMAT_JSON_LINES:
+            break;
+        case NARWHAL_REPORTER_FORMAT_TAP:
+            fprintf(reporter->stream, "TAP version 13\n");
+            break;
+    }
+}
+
+void narwhal_reporter_test_result(NarwhalReporter *reporter,
+                                  const NarwhalTestSession *test_session,
+                                  const NarwhalTestResult *test_result)
+{
+    (void)test_session;
+
+    reporter->count++;
+
+    switch (reporter->format)
+    {
+        case NARWHAL_REPORTER_FORMAT_TEXT:
+            narwhal_output_session_progress(
+                reporter->stream, &reporter->output_state, test_result);
+            break;
+        case NARWHAL_REPORTER_FORMAT_JUNIT:
+            junit_test_result(
+                reporter->pending != NULL ? reporter->pending : reporter->stream, test_result);
+            break;
+        case NARWHAL_REPORTER_FORMAT_JSON_LINES:
+            json_lines_test_result(reporter->stream, test_result);
+            break;
+        case NARWHAL_REPORTER_FORMAT_TAP:
+            tap_test_result(reporter->stream, reporter->count, test_result);
+            break;
+    }
+}
+
+void narwhal_reporter_session_end(NarwhalReporter *reporter,
+                                  const NarwhalTestSession *test_session)
+{
+    switch (reporter->format)
+    {
+        case NARWHAL_REPORTER_FORMAT_TEXT:
+            narwhal_output_session_result(
+                reporter->stream, &reporter->output_state, test_session);
+            break;
+        case NARWHAL_REPORTER_FORMAT_JUNIT:
+            junit_session_end(reporter, test_session);
+            break;
+        case NARWHAL_REPORTER_FORMAT_JSON_LINES:
+            json_lines_session_end(reporter->stream, test_session);
+            break;
+        case NARWHAL_REPORTER_FORMAT_TAP:
+            fprintf(reporter->stream, "1..%zu\n", reporter->count);
+            break;
+    }
+
+    fflush(reporter->stream);
+}
+
+/*
+ * Cleanup
+ */
+
+void narwhal_free_reporter(NarwhalReporter *reporter)
+{
+    if (reporter->pending != NULL)
+    {
+        fclose(reporter->pending);
+    }
+
+    if (reporter->owns_stream)
+    {
+        fclose(reporter->stream);
+    }
+
+    free(reporter);
+}
@@ -0,0 +1,51 @@
+#ifndef NARWHAL_REPORTER_H
+#define NARWHAL_REPORTER_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "narwhal/session/session.h"
+#include "narwhal/types.h"
+
+enum NarwhalReporterFormat
+{
+    NARWHAL_REPORTER_FORMAT_TEXT,
+    NARWHAL_REPORTER_FORMAT_JUNIT,
+    NARWHAL_REPORTER_FORMAT_JSON_LINES,
+    NARWHAL_REPORTER_FORMAT_TAP
+};
+
+struct NarwhalReporterConfig
+{
+    NarwhalReporterFormat format;
+    const char *filename;
+};
+
+struct NarwhalReporter
+{
+    NarwhalReporterFormat format;
+    FILE *stream;
+    bool owns_stream;
+    FILE *pending;
+    size_t count;
+    NarwhalSessionOutputState output_state;
+};
+
+NarwhalReporterConfig *narwhal_parse_reporter_config(const char *value);
+void narwhal_free_reporter_config(NarwhalReporterConfig *reporter_config);
+
+NarwhalReporter *narwhal_new_reporter(NarwhalReporterFormat format,
+                                      FILE *stream,
+                                      bool owns_stream);
+
+void narwhal_reporter_session_start(NarwhalReporter *reporter,
+                                    const NarwhalTestSession *test_session);
+void narwhal_reporter_test_result(NarwhalReporter *reporter,
+                                  const NarwhalTestSession *test_session,
+                                  const NarwhalTestResult *test_result);
+void narwhal_reporter_session_end(NarwhalReporter *reporter,
+                                  const NarwhalTestSession *test_session);
+
+void narwhal_free_reporter(NarwhalReporter *reporter);
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef NARWHAL_REPORTER_TYPES_H
+#define NARWHAL_REPORTER_TYPES_H
+
+typedef struct NarwhalReporter NarwhalReporter;
+typedef struct NarwhalReporterConfig NarwhalReporterConfig;
+typedef enum NarwhalReporterFormat NarwhalReporterFormat;
+
+#endif
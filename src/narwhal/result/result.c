@@ -1,6 +1,7 @@
 #include "narwhal/result/result.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,6 +9,7 @@
 #include <unistd.h>
 
 #include "narwhal/collection/collection.h"
+#include "narwhal/compression/compression.h"
 #include "narwhal/param/param.h"
 #include "narwhal/test/test.h"
 #include "narwhal/test_utils/test_utils.h"
@@ -26,12 +28,18 @@ static void initialize_test_result(NarwhalTestResult *test_result)
     test_result->assertion_line = 0;
     test_result->test = NULL;
     test_result->param_snapshots = narwhal_empty_collection();
+    test_result->output_file = -1;
     test_result->output_buffer = NULL;
     test_result->output_length = 0;
+    test_result->output_elided = 0;
     test_result->diff_original = NULL;
     test_result->diff_original_size = 0;
     test_result->diff_modified = NULL;
     test_result->diff_modified_size = 0;
+    test_result->compressed = false;
+    test_result->output_compressed_size = 0;
+    test_result->diff_original_compressed_size = 0;
+    test_result->diff_modified_compressed_size = 0;
 }
 
 NarwhalTestResult *narwhal_new_test_result(void)
@@ -51,6 +59,98 @@ bool narwhal_test_result_has_diff(const NarwhalTestResult *test_result)
     return test_result->diff_original != NULL && test_result->diff_modified != NULL;
 }
 
+void narwhal_test_result_close_output(NarwhalTestResult *test_result)
+{
+    if (test_result->output_file != -1)
+    {
+        close(test_result->output_file);
+        test_result->output_file = -1;
+    }
+}
+
+/*
+ * Compression
+ */
+
+static size_t compress_buffer(char **buffer, size_t size)
+{
+    if (*buffer == NULL || size < NARWHAL_COMPRESSION_MIN_SIZE || size >= UINT32_MAX)
+    {
+        return 0;
+    }
+
+    char *compressed = malloc(narwhal_compress_bound(size));
+    size_t compressed_size = narwhal_compress(*buffer, size, compressed);
+
+    if (compressed_size >= size)
+    {
+        free(compressed);
+        return 0;
+    }
+
+    free(*buffer);
+    *buffer = realloc(compressed, compressed_size);
+
+    return compressed_size;
+}
+
+static void decompress_buffer(char **buffer, size_t size, size_t *compressed_size)
+{
+    if (*compressed_size == 0)
+    {
+        return;
+    }
+
+    char *decompressed = malloc(size);
+
+    if (!narwhal_decompress(*buffer, *compressed_size, decompressed, size))
+    {
+        fprintf(stderr, "Failed to decompress test result.\n");
+        memset(decompressed, 0, size);
+    }
+
+    free(*buffer);
+    *buffer = decompressed;
+    *compressed_size = 0;
+}
+
+void narwhal_compress_test_result(NarwhalTestResult *test_result)
+{
+    if (test_result->compressed)
+    {
+        return;
+    }
+
+    test_result->output_compressed_size =
+        compress_buffer(&test_result->output_buffer, test_result->output_length + 1);
+    test_result->diff_original_compressed_size =
+        compress_buffer(&test_result->diff_original, test_result->diff_original_size);
+    test_result->diff_modified_compressed_size =
+        compress_buffer(&test_result->diff_modified, test_result->diff_modified_size);
+
+    test_result->compressed = true;
+}
+
+void narwhal_decompress_test_result(NarwhalTestResult *test_result)
+{
+    if (!test_result->compressed)
+    {
+        return;
+    }
+
+    decompress_buffer(&test_result->output_buffer,
+                      test_result->output_length + 1,
+                      &test_result->output_compressed_size);
+    decompress_buffer(&test_result->diff_original,
+                      test_result->diff_original_size,
+                      &test_result->diff_original_compressed_size);
+    decompress_buffer(&test_result->diff_modified,
+                      test_result->diff_modified_size,
+                      &test_result->diff_modified_compressed_size);
+
+    test_result->compressed = false;
+}
+
 /*
  * Pipe test result data
  */
@@ -200,6 +300,7 @@ void narwhal_free_test_result(NarwhalTestResult *test_result)
     }
     narwhal_free_collection(test_result->param_snapshots);
 
+    narwhal_test_result_close_output(test_result);
     free(test_result->output_buffer);
     free(test_result->failed_assertion);
 
@@ -8,6 +8,13 @@
 
 #include "narwhal/types.h"
 
+struct NarwhalOutputLimits
+{
+    bool enabled;
+    size_t head_size;
+    size_t tail_size;
+};
+
 struct NarwhalTestResult
 {
     bool success;
@@ -21,18 +28,26 @@ struct NarwhalTestResult
     struct timeval start_time;
     struct timeval end_time;
     int pipe[2];
-    int output_pipe[2];
+    int output_file;
     char *output_buffer;
     size_t output_length;
+    size_t output_elided;
     char *diff_original;
     size_t diff_original_size;
     char *diff_modified;
     size_t diff_modified_size;
+    bool compressed;
+    size_t output_compressed_size;
+    size_t diff_original_compressed_size;
+    size_t diff_modified_compressed_size;
 };
 
 NarwhalTestResult *narwhal_new_test_result(void);
 
 bool narwhal_test_result_has_diff(const NarwhalTestResult *test_result);
+void narwhal_test_result_close_output(NarwhalTestResult *test_result);
+void narwhal_compress_test_result(NarwhalTestResult *test_result);
+void narwhal_decompress_test_result(NarwhalTestResult *test_result);
 
 void narwhal_pipe_test_info(NarwhalTestResult *test_result,
                             struct timeval start_time,
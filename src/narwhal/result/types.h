@@ -3,5 +3,6 @@
 
 typedef struct NarwhalTestResult NarwhalTestResult;
 typedef struct NarwhalTestParamSnapshot NarwhalTestParamSnapshot;
+typedef struct NarwhalOutputLimits NarwhalOutputLimits;
 
 #endif
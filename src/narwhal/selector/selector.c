@@ -0,0 +1,367 @@
+#include "narwhal/selector/selector.h"
+
+#include <regex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "narwhal/collection/collection.h"
+#include "narwhal/group/group.h"
+#include "narwhal/test/test.h"
+
+/*
+ * Selector initialization
+ */
+
+static bool parse_param_selections(NarwhalCollection *param_selections, const char *string)
+{
+    while (true)
+    {
+        const char *equal = strchr(string, '=');
+        const char *end = strchr(string, ',');
+
+        if (end == NULL)
+        {
+            end = string + strlen(string);
+        }
+
+        if (equal == NULL || equal == string || equal > end || equal + 1 == end)
+        {
+            return false;
+        }
+
+        size_t index = 0;
+
+        for (const char *digit = equal + 1; digit < end; digit++)
+        {
+            if (*digit < '0' || *digit > '9')
+            {
+                return false;
+            }
+
+            size_t value = (size_t)(*digit - '0');
+
+            if (index > (SIZE_MAX - value) / 10)
+            {
+                return false;
+            }
+
+            index = index * 10 + value;
+        }
+
+        NarwhalParamSelection *param_selection = malloc(sizeof(NarwhalParamSelection));
+        param_selection->name = strndup(string, (size_t)(equal - string));
+        param_selection->index = index;
+
+        narwhal_collection_append(param_selections, param_selection);
+
+        if (*end == '\0')
+        {
+            return true;
+        }
+
+        string = end + 1;
+    }
+}
+
+static bool split_param_selections(NarwhalTestSelector *selector, const char *pattern)
+{
+    size_t length = strlen(pattern);
+    const char *bracket = strrchr(pattern, '[');
+
+    if (length == 0 || pattern[length - 1] != ']' || bracket == NULL ||
+        memchr(bracket, '=', (size_t)(pattern + length - bracket)) == NULL)
+    {
+        selector->pattern = strdup(pattern);
+        return true;
+    }
+
+    selector->pattern = strndup(pattern, (size_t)(bracket - pattern));
+
+    char *selections = strndup(bracket + 1, (size_t)(pattern + length - bracket - 2));
+    bool valid = parse_param_selections(selector->param_selections, selections);
+    free(selections);
+
+    if (!valid)
+    {
+        fprintf(stderr, "Invalid parameter selection \"%s\".\n", bracket);
+    }
+
+    return valid;
+}
+
+static bool initialize_test_selector(NarwhalTestSelector *selector,
+                                     const char *pattern,
+                                     bool regex)
+{
+    selector->regex = false;
+    selector->param_selections = narwhal_empty_collection();
+
+    if (!split_param_selections(selector, pattern))
+    {
+        return false;
+    }
+
+    if (!regex)
+    {
+        return true;
+    }
+
+    int status =
+        regcomp(&selector->compiled_regex, selector->pattern, REG_EXTENDED | REG_NOSUB);
+
+    if (status != 0)
+    {
+        char message[256];
+        regerror(status, &selector->compiled_regex, message, sizeof(message));
+        fprintf(stderr, "Invalid regular expression \"%s\": %s.\n", selector->pattern, message);
+
+        return false;
+    }
+
+    selector->regex = true;
+
+    return true;
+}
+
+NarwhalTestSelector *narwhal_new_test_selector(const char *pattern, bool regex)
+{
+    NarwhalTestSelector *selector = malloc(sizeof(NarwhalTestSelector));
+
+    if (!initialize_test_selector(selector, pattern, regex))
+    {
+        narwhal_free_test_selector(selector);
+        return NULL;
+    }
+
+    return selector;
+}
+
+/*
+ * Glob matching
+ */
+
+static const char *match_character_class(const char *pattern, char chr, bool *matched)
+{
+    bool negated = *pattern == '!' || *pattern == '^';
+
+    if (negated)
+    {
+        pattern++;
+    }
+
+    const char *start = pattern;
+    bool found = false;
+
+    while (*pattern != '\0' && (*pattern != ']' || pattern == start))
+    {
+        char low = *pattern;
+        char high = low;
+
+        if (pattern[1] == '-' && pattern[2] != ']' && pattern[2] != '\0')
+        {
+            high = pattern[2];
+            pattern += 3;
+        }
+        else
+        {
+            pattern++;
+        }
+
+        if (low <= chr && chr <= high)
+        {
+            found = true;
+        }
+    }
+
+    if (*pattern != ']')
+    {
+        return NULL;
+    }
+
+    *matched = found != negated;
+
+    return pattern + 1;
+}
+
+bool narwhal_glob_match(const char *pattern, const char *string, bool partial)
+{
+    const char *star_pattern = NULL;
+    const char *star_string = NULL;
+
+    while (true)
+    {
+        if (*pattern == '*')
+        {
+            star_pattern = ++pattern;
+            star_string = string;
+            continue;
+        }
+
+        if (*string == '\0')
+        {
+            return partial || *pattern == '\0';
+        }
+
+        bool matched = false;
+        const char *next_pattern = pattern + 1;
+
+        if (*pattern == '?')
+        {
+            matched = true;
+        }
+        else if (*pattern == '[')
+        {
+            next_pattern = match_character_class(pattern + 1, *string, &matched);
+
+            if (next_pattern == NULL)
+            {
+                matched = *string == '[';
+                next_pattern = pattern + 1;
+            }
+        }
+        else if (*pattern == '\\' && pattern[1] != '\0')
+        {
+            matched = pattern[1] == *string;
+            next_pattern = pattern + 2;
+        }
+        else if (*pattern != '\0')
+        {
+            matched = *pattern == *string;
+        }
+
+        if (matched)
+        {
+            pattern = next_pattern;
+            string++;
+        }
+        else if (star_pattern != NULL)
+        {
+            pattern = star_pattern;
+            string = ++star_string;
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
+
+/*
+ * Match full names
+ */
+
+bool narwhal_test_selector_match(const NarwhalTestSelector *selector, const char *full_name)
+{
+    if (selector->regex)
+    {
+        return regexec(&selector->compiled_regex, full_name, 0, NULL, 0) == 0;
+    }
+
+    return narwhal_glob_match(selector->pattern, full_name, false);
+}
+
+bool narwhal_test_selector_selects_test(const NarwhalTestSelector *selector,
+                                        const NarwhalTest *test)
+{
+    const NarwhalTestGroup *test_group = test->group;
+
+    if (test_group == NULL || test_group->full_name == NULL)
+    {
+        return narwhal_test_selector_match(selector, test->name);
+    }
+
+    size_t group_length = strlen(test_group->full_name);
+    size_t name_size = strlen(test->name) + 1;
+    char full_name[group_length + 1 + name_size];
+
+    memcpy(full_name, test_group->full_name, group_length);
+    full_name[group_length] = '/';
+    memcpy(full_name + group_length + 1, test->name, name_size);
+
+    if (narwhal_test_selector_match(selector, full_name))
+    {
+        return true;
+    }
+
+    for (; test_group != NULL && test_group->full_name != NULL; test_group = test_group->group)
+    {
+        if (narwhal_test_selector_match(selector, test_group->full_name))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool narwhal_test_selector_may_match_within(const NarwhalTestSelector *selector,
+                                            const char *group_full_name)
+{
+    if (selector->regex)
+    {
+        return true;
+    }
+
+    size_t length = strlen(group_full_name);
+    char prefix[length + 2];
+
+    memcpy(prefix, group_full_name, length);
+    prefix[length] = '/';
+    prefix[length + 1] = '\0';
+
+    return narwhal_glob_match(selector->pattern, prefix, true);
+}
+
+bool narwhal_selectors_match(const NarwhalCollection *selectors, const char *full_name)
+{
+    NarwhalTestSelector *selector;
+    NARWHAL_EACH(selector, selectors)
+    {
+        if (narwhal_test_selector_match(selector, full_name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool narwhal_selectors_may_match_within(const NarwhalCollection *selectors,
+                                        const char *group_full_name)
+{
+    NarwhalTestSelector *selector;
+    NARWHAL_EACH(selector, selectors)
+    {
+        if (narwhal_test_selector_may_match_within(selector, group_full_name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Cleanup
+ */
+
+void narwhal_free_test_selector(NarwhalTestSelector *selector)
+{
+    if (selector->regex)
+    {
+        regfree(&selector->compiled_regex);
+    }
+
+    while (selector->param_selections->count > 0)
+    {
+        NarwhalParamSelection *param_selection =
+            narwhal_collection_pop(selector->param_selections);
+        free(param_selection->name);
+        free(param_selection);
+    }
+    narwhal_free_collection(selector->param_selections);
+
+    free(selector->pattern);
+    free(selector);
+}
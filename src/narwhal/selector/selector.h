@@ -0,0 +1,37 @@
+#ifndef NARWHAL_SELECTOR_H
+#define NARWHAL_SELECTOR_H
+
+#include <regex.h>
+#include <stdbool.h>
+
+#include "narwhal/types.h"
+
+struct NarwhalTestSelector
+{
+    char *pattern;
+    bool regex;
+    regex_t compiled_regex;
+    NarwhalCollection *param_selections;
+};
+
+struct NarwhalParamSelection
+{
+    char *name;
+    size_t index;
+};
+
+NarwhalTestSelector *narwhal_new_test_selector(const char *pattern, bool regex);
+bool narwhal_test_selector_match(const NarwhalTestSelector *selector, const char *full_name);
+bool narwhal_test_selector_selects_test(const NarwhalTestSelector *selector,
+                                        const NarwhalTest *test);
+bool narwhal_test_selector_may_match_within(const NarwhalTestSelector *selector,
+                                            const char *group_full_name);
+bool narwhal_glob_match(const char *pattern, const char *string, bool partial);
+
+bool narwhal_selectors_match(const NarwhalCollection *selectors, const char *full_name);
+bool narwhal_selectors_may_match_within(const NarwhalCollection *selectors,
+                                        const char *group_full_name);
+
+void narwhal_free_test_selector(NarwhalTestSelector *selector);
+
+#endif
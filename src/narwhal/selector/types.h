@@ -0,0 +1,7 @@
+#ifndef NARWHAL_SELECTOR_TYPES_H
+#define NARWHAL_SELECTOR_TYPES_H
+
+typedef struct NarwhalTestSelector NarwhalTestSelector;
+typedef struct NarwhalParamSelection NarwhalParamSelection;
+
+#endif
@@ -1,12 +1,18 @@
 #include "narwhal/session/session.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 #include "narwhal/collection/collection.h"
+#include "narwhal/combination/combination.h"
 #include "narwhal/group/group.h"
+#include "narwhal/options/options.h"
 #include "narwhal/output/output.h"
+#include "narwhal/output_log/output_log.h"
 #include "narwhal/param/param.h"
+#include "narwhal/reporter/reporter.h"
 #include "narwhal/result/result.h"
 #include "narwhal/test/test.h"
 
@@ -18,6 +24,12 @@ static void initialize_test_session(NarwhalTestSession *test_session)
 {
     test_session->results = narwhal_empty_collection();
     test_session->failures = narwhal_empty_collection();
+    test_session->result_count = 0;
+    test_session->failure_count = 0;
+    test_session->sampled = false;
+    test_session->output_log = NULL;
+    test_session->report_stream = NULL;
+    test_session->reporters = narwhal_empty_collection();
 }
 
 NarwhalTestSession *narwhal_new_test_session(void)
@@ -32,68 +44,201 @@ NarwhalTestSession *narwhal_new_test_session(void)
  * Test session hooks
  */
 
-void narwhal_test_session_start(NarwhalTestSession *test_session)
+static void add_reporters(NarwhalTestSession *test_session, NarwhalCollection *reporter_configs)
+{
+    if (reporter_configs == NULL || reporter_configs->count == 0)
+    {
+        NarwhalReporter *reporter = narwhal_new_reporter(
+            NARWHAL_REPORTER_FORMAT_TEXT, test_session->report_stream, false);
+        narwhal_collection_append(test_session->reporters, reporter);
+        return;
+    }
+
+    NarwhalReporterConfig *reporter_config;
+    NARWHAL_EACH(reporter_config, reporter_configs)
+    {
+        FILE *stream = test_session->report_stream;
+
+        if (reporter_config->filename != NULL)
+        {
+            stream = narwhal_open_report_file(reporter_config->filename);
+        }
+
+        if (stream != NULL)
+        {
+            bool owns_stream = stream != test_session->report_stream;
+            narwhal_collection_append(
+                test_session->reporters,
+                narwhal_new_reporter(reporter_config->format, stream, owns_stream));
+        }
+    }
+}
+
+bool narwhal_test_session_start(NarwhalTestSession *test_session)
 {
     gettimeofday(&test_session->start_time, NULL);
 
-    narwhal_output_session_init(test_session);
+    if (_narwhal_current_options->output_log != NULL)
+    {
+        test_session->output_log = narwhal_open_output_log(_narwhal_current_options->output_log);
+
+        if (test_session->output_log == NULL)
+        {
+            return false;
+        }
+    }
+
+    if (_narwhal_current_options->report_file != NULL)
+    {
+        test_session->report_stream =
+            narwhal_open_report_file(_narwhal_current_options->report_file);
+
+        if (test_session->report_stream == NULL)
+        {
+            if (test_session->output_log != NULL)
+            {
+                narwhal_close_output_log(test_session->output_log);
+                test_session->output_log = NULL;
+            }
+
+            return false;
+        }
+    }
+
+    if (test_session->report_stream == NULL)
+    {
+        fflush(stdout);
+        test_session->report_stream = narwhal_open_report_stream(STDOUT_FILENO);
+    }
+
+    add_reporters(test_session, _narwhal_current_options->reporters);
+
+    NarwhalReporter *reporter;
+    NARWHAL_EACH(reporter, test_session->reporters)
+    {
+        narwhal_reporter_session_start(reporter, test_session);
+    }
+
+    return true;
 }
 
 void narwhal_test_session_end(NarwhalTestSession *test_session)
 {
     gettimeofday(&test_session->end_time, NULL);
 
-    narwhal_output_session_result(test_session);
+    NarwhalReporter *reporter;
+    NARWHAL_EACH(reporter, test_session->reporters)
+    {
+        narwhal_reporter_session_end(reporter, test_session);
+    }
+
+    if (test_session->output_log != NULL)
+    {
+        narwhal_close_output_log(test_session->output_log);
+        test_session->output_log = NULL;
+    }
+
+    while (test_session->reporters->count > 0)
+    {
+        NarwhalReporter *reporter = narwhal_collection_pop(test_session->reporters);
+        narwhal_free_reporter(reporter);
+    }
+
+    fclose(test_session->report_stream);
+    test_session->report_stream = NULL;
 }
 
 /*
  * Run test session
  */
 
+static bool keep_result(const NarwhalTestSession *test_session,
+                        const NarwhalTestResult *test_result)
+{
+    if (!_narwhal_current_options->streaming)
+    {
+        return true;
+    }
+
+    return !test_result->success &&
+           test_session->failures->count < _narwhal_current_options->kept_failures;
+}
+
 static void register_result(NarwhalTestSession *test_session, NarwhalTestResult *test_result)
 {
+    test_session->result_count++;
+
+    if (!test_result->success)
+    {
+        test_session->failure_count++;
+    }
+
+    if (test_session->output_log != NULL)
+    {
+        narwhal_output_log_append(test_session->output_log, test_result);
+    }
+
+    NarwhalReporter *reporter;
+    NARWHAL_EACH(reporter, test_session->reporters)
+    {
+        narwhal_reporter_test_result(reporter, test_session, test_result);
+    }
+
+    if (!keep_result(test_session, test_result))
+    {
+        test_result->test->result = NULL;
+        narwhal_free_test_result(test_result);
+        return;
+    }
+
     narwhal_collection_append(test_session->results, test_result);
 
     if (!test_result->success)
     {
         narwhal_collection_append(test_session->failures, test_result);
     }
+
+    narwhal_test_result_close_output(test_result);
+    narwhal_compress_test_result(test_result);
 }
 
 void narwhal_test_session_run_test(NarwhalTestSession *test_session, NarwhalTest *test)
 {
     narwhal_run_test(test);
     register_result(test_session, test->result);
-
-    narwhal_output_session_progress(test_session);
 }
 
 void narwhal_test_session_run_parameterized_test(NarwhalTestSession *test_session,
-                                                 NarwhalTest *test,
-                                                 NarwhalCollectionItem *param_item)
+                                                 NarwhalTest *test)
 {
-    if (param_item == NULL)
+    NarwhalParamCombinations *combinations = narwhal_new_param_combinations(test);
+
+    if (combinations->sampled)
     {
-        narwhal_test_session_run_test(test_session, test);
-        return;
+        test_session->sampled = true;
     }
 
-    NarwhalTestParam *param = param_item->value;
-
-    for (param->index = 0; param->index < param->count; param->index++)
+    while (narwhal_param_combinations_next(combinations))
     {
-        narwhal_test_session_run_parameterized_test(test_session, test, param_item->next);
+        narwhal_test_session_run_test(test_session, test);
     }
+
+    narwhal_free_param_combinations(combinations);
 }
 
 void narwhal_test_session_run_test_group(NarwhalTestSession *test_session,
                                          NarwhalTestGroup *test_group,
                                          bool only)
 {
+    narwhal_materialize_test_group(test_group);
+
     NarwhalTestGroup *subgroup;
     NARWHAL_EACH(subgroup, test_group->subgroups)
     {
-        narwhal_test_session_run_test_group(test_session, subgroup, only);
+        if (!only || subgroup->only)
+        {
+            narwhal_test_session_run_test_group(test_session, subgroup, only);
+        }
     }
 
     NarwhalTest *test;
@@ -101,7 +246,7 @@ void narwhal_test_session_run_test_group(NarwhalTestSession *test_session,
     {
         if (!test->skip && (!only || test->only))
         {
-            narwhal_test_session_run_parameterized_test(test_session, test, test->params->first);
+            narwhal_test_session_run_parameterized_test(test_session, test);
         }
     }
 }
@@ -125,5 +270,7 @@ void narwhal_free_test_session(NarwhalTestSession *test_session)
     }
     narwhal_free_collection(test_session->failures);
 
+    narwhal_free_collection(test_session->reporters);
+
     free(test_session);
 }
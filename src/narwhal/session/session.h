@@ -2,6 +2,7 @@
 #define NARWHAL_SESSION_H
 
 #include <stdbool.h>
+#include <stdio.h>
 #include <sys/time.h>
 
 #include "narwhal/types.h"
@@ -10,6 +11,8 @@ struct NarwhalSessionOutputState
 {
     int index;
     int length;
+    int displayed_length;
+    struct timeval refresh_time;
     char string[50];
 };
 
@@ -17,20 +20,24 @@ struct NarwhalTestSession
 {
     NarwhalCollection *results;
     NarwhalCollection *failures;
+    size_t result_count;
+    size_t failure_count;
+    bool sampled;
     struct timeval start_time;
     struct timeval end_time;
-    NarwhalSessionOutputState output_state;
+    NarwhalOutputLog *output_log;
+    FILE *report_stream;
+    NarwhalCollection *reporters;
 };
 
 NarwhalTestSession *narwhal_new_test_session(void);
 
-void narwhal_test_session_start(NarwhalTestSession *test_session);
+bool narwhal_test_session_start(NarwhalTestSession *test_session);
 void narwhal_test_session_end(NarwhalTestSession *test_session);
 
 void narwhal_test_session_run_test(NarwhalTestSession *test_session, NarwhalTest *test);
 void narwhal_test_session_run_parameterized_test(NarwhalTestSession *test_session,
-                                                 NarwhalTest *test,
-                                                 NarwhalCollectionItem *param_item);
+                                                 NarwhalTest *test);
 void narwhal_test_session_run_test_group(NarwhalTestSession *test_session,
                                          NarwhalTestGroup *test_group,
                                          bool only);
@@ -5,17 +5,21 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
+#include "narwhal/arena/arena.h"
 #include "narwhal/collection/collection.h"
 #include "narwhal/fixture/fixture.h"
+#include "narwhal/options/options.h"
 #include "narwhal/param/param.h"
 #include "narwhal/result/result.h"
 #include "narwhal/test/test.h"
+#include "narwhal/test_utils/test_utils.h"
 #include "narwhal/unused_attribute.h"
 #include "narwhal/utils.h"
 
@@ -44,13 +48,18 @@ static void initialize_test(NarwhalTest *test,
     test->only = false;
     test->skip = false;
     test->timeout = 0;
+    test->output_limits = (NarwhalOutputLimits){ false, 0, 0 };
+    test->combination_strength = 0;
+    test->sample_count = 0;
+    test->sample_budget = 0;
     test->group = NULL;
     test->function = function;
-    test->resources = narwhal_empty_collection();
+    test->resources = narwhal_new_arena(NARWHAL_ARENA_BLOCK_SIZE);
     test->fixtures = narwhal_empty_collection();
     test->params = narwhal_empty_collection();
     test->accessible_fixtures = narwhal_empty_collection();
     test->accessible_params = narwhal_empty_collection();
+    test->constraints = narwhal_empty_collection();
     test->result = NULL;
     test->output_capture = NULL;
     test->reset_all_mocks = reset_all_mocks;
@@ -90,7 +99,7 @@ NarwhalTest *narwhal_new_test(const char *name,
 
 void narwhal_free_after_test(NarwhalTest *test, void *resource)
 {
-    narwhal_collection_append(test->resources, resource);
+    narwhal_arena_adopt(test->resources, resource);
 }
 
 void auto_free(void *resource)
@@ -98,11 +107,14 @@ void auto_free(void *resource)
     narwhal_free_after_test(_narwhal_current_test, resource);
 }
 
+void narwhal_unmap_after_test(NarwhalTest *test, void *mapping, size_t size)
+{
+    narwhal_arena_adopt_mapping(test->resources, mapping, size);
+}
+
 void *narwhal_test_resource(NarwhalTest *test, size_t size)
 {
-    void *resource = malloc(size);
-    narwhal_free_after_test(test, resource);
-    return resource;
+    return narwhal_arena_alloc(test->resources, size, NARWHAL_ARENA_DEFAULT_ALIGNMENT);
 }
 
 void *test_resource(size_t size)
@@ -110,13 +122,46 @@ void *test_resource(size_t size)
     return narwhal_test_resource(_narwhal_current_test, size);
 }
 
-void narwhal_free_test_resources(NarwhalTest *test)
+void *narwhal_test_resource_aligned(NarwhalTest *test, size_t size, size_t alignment)
+{
+    return narwhal_arena_alloc(test->resources, size, alignment);
+}
+
+void *test_resource_aligned(size_t size, size_t alignment)
+{
+    return narwhal_test_resource_aligned(_narwhal_current_test, size, alignment);
+}
+
+void *narwhal_test_resource_zeroed(NarwhalTest *test, size_t size)
 {
-    while (test->resources->count > 0)
+    void *resource = narwhal_test_resource(test, size);
+
+    if (resource != NULL)
     {
-        void *test_resource = narwhal_collection_pop(test->resources);
-        free(test_resource);
+        memset(resource, 0, size);
     }
+
+    return resource;
+}
+
+void *test_resource_zeroed(size_t size)
+{
+    return narwhal_test_resource_zeroed(_narwhal_current_test, size);
+}
+
+void *narwhal_test_resource_realloc(NarwhalTest *test, void *resource, size_t size)
+{
+    return narwhal_arena_realloc(test->resources, resource, size);
+}
+
+void *test_resource_realloc(void *resource, size_t size)
+{
+    return narwhal_test_resource_realloc(_narwhal_current_test, resource, size);
+}
+
+void narwhal_free_test_resources(NarwhalTest *test)
+{
+    narwhal_arena_reset(test->resources);
 }
 
 void narwhal_call_reset_all_mocks(NarwhalTest *test)
@@ -231,13 +276,81 @@ static void report_failure(NarwhalTestResult *test_result)
     pull_data(&test_result->end_time, sizeof(struct timeval));
 }
 
+static size_t read_output_range(int file, char *buffer, size_t offset, size_t size)
+{
+    size_t bytes_read = 0;
+
+    while (bytes_read < size)
+    {
+        ssize_t count =
+            pread(file, buffer + bytes_read, size - bytes_read, (off_t)(offset + bytes_read));
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        bytes_read += (size_t)count;
+    }
+
+    return bytes_read;
+}
+
 static void report_output(NarwhalTestResult *test_result)
 {
-    FILE *stream = fdopen(test_result->output_pipe[0], "r");
+    struct stat file_stat;
 
-    test_result->output_length = narwhal_util_read_stream(stream, &test_result->output_buffer);
+    if (fstat(test_result->output_file, &file_stat) == -1 || file_stat.st_size == 0)
+    {
+        return;
+    }
+
+    size_t file_size = (size_t)file_stat.st_size;
+
+    const NarwhalOutputLimits *limits = &test_result->test->output_limits;
+
+    if (!limits->enabled)
+    {
+        limits = &_narwhal_current_options->output_limits;
+    }
+
+    if (!limits->enabled || file_size - narwhal_min_size_t(limits->head_size, file_size) <=
+                                limits->tail_size)
+    {
+        test_result->output_buffer = malloc(file_size + 1);
+        test_result->output_length =
+            read_output_range(test_result->output_file, test_result->output_buffer, 0, file_size);
+        test_result->output_buffer[test_result->output_length] = '\0';
+
+        return;
+    }
+
+    test_result->output_elided = file_size - limits->head_size - limits->tail_size;
+
+    char marker[64];
+    int marker_length = snprintf(marker,
+                                 sizeof(marker),
+                                 "\n[... %zu bytes elided ...]\n",
+                                 test_result->output_elided);
+
+    char *output_buffer =
+        malloc(limits->head_size + (size_t)marker_length + limits->tail_size + 1);
+
+    size_t output_length =
+        read_output_range(test_result->output_file, output_buffer, 0, limits->head_size);
+
+    memcpy(output_buffer + output_length, marker, (size_t)marker_length);
+    output_length += (size_t)marker_length;
+
+    output_length += read_output_range(test_result->output_file,
+                                       output_buffer + output_length,
+                                       file_size - limits->tail_size,
+                                       limits->tail_size);
 
-    fclose(stream);
+    output_buffer[output_length] = '\0';
+
+    test_result->output_buffer = output_buffer;
+    test_result->output_length = output_length;
 }
 
 #undef pull_data
@@ -411,6 +524,18 @@ void narwhal_run_test(NarwhalTest *test)
 
     NarwhalTestResult *test_result = test->result;
 
+    NarwhalTestParam *test_param;
+    NARWHAL_EACH(test_param, test->params)
+    {
+        if (test_param->error != NULL)
+        {
+            gettimeofday(&test_result->start_time, NULL);
+            test_result->end_time = test_result->start_time;
+            test_error(test_result, test_param->error, strlen(test_param->error) + 1);
+            return;
+        }
+    }
+
     if (pipe(test_result->pipe) == -1)
     {
         char message[] = "Couldn't create the test pipe.";
@@ -418,9 +543,9 @@ void narwhal_run_test(NarwhalTest *test)
         return;
     }
 
-    if (pipe(test_result->output_pipe) == -1)
+    if ((test_result->output_file = narwhal_create_output_file()) == -1)
     {
-        char message[] = "Couldn't create the output pipe.";
+        char message[] = "Couldn't create the output file.";
         test_error(test_result, message, sizeof(message));
 
         close(test_result->pipe[0]);
@@ -429,6 +554,9 @@ void narwhal_run_test(NarwhalTest *test)
         return;
     }
 
+    // The child would otherwise write out the buffered report again when it exits
+    fflush(NULL);
+
     pid_t test_pid = fork();
 
     if (test_pid == -1)
@@ -438,8 +566,7 @@ void narwhal_run_test(NarwhalTest *test)
 
         close(test_result->pipe[0]);
         close(test_result->pipe[1]);
-        close(test_result->output_pipe[0]);
-        close(test_result->output_pipe[1]);
+        close(test_result->output_file);
 
         return;
     }
@@ -447,12 +574,14 @@ void narwhal_run_test(NarwhalTest *test)
     {
         close(test_result->pipe[0]);
 
-        while (dup2(test_result->output_pipe[1], STDOUT_FILENO) == -1 && errno == EINTR)
+        while (dup2(test_result->output_file, STDOUT_FILENO) == -1 && errno == EINTR)
             ;
-        while (dup2(test_result->output_pipe[1], STDERR_FILENO) == -1 && errno == EINTR)
+        while (dup2(test_result->output_file, STDERR_FILENO) == -1 && errno == EINTR)
             ;
-        close(test_result->output_pipe[0]);
-        close(test_result->output_pipe[1]);
+        close(test_result->output_file);
+
+        // Keep stdout and stderr in order in the output, whatever the runner writes to
+        setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
 
         int test_status = execute_test_function(test);
 
@@ -463,7 +592,6 @@ void narwhal_run_test(NarwhalTest *test)
     gettimeofday(&test_result->start_time, NULL);
 
     close(test_result->pipe[1]);
-    close(test_result->output_pipe[1]);
 
     int test_status;
 
@@ -484,9 +612,11 @@ void narwhal_run_test(NarwhalTest *test)
         report_failure(test_result);
     }
 
-    report_output(test_result);
+    if (!test_result->success)
+    {
+        report_output(test_result);
+    }
 
-    close(test_result->output_pipe[0]);
     close(test_result->pipe[0]);
 }
 
@@ -547,6 +677,7 @@ static void only_registration_function(NarwhalTest *test,
     test->only = true;
 }
 
+// Group scanning recognizes this registration without running it, see has_only_modifier
 NarwhalTestModifierRegistration narwhal_test_set_only = { only_registration_function, NULL };
 
 static void skip_registration_function(NarwhalTest *test,
@@ -569,6 +700,18 @@ void narwhal_timeout_registration_function(NarwhalTest *test,
     test->timeout = timeout->milliseconds;
 }
 
+void narwhal_output_limits_registration_function(NarwhalTest *test,
+                                                 _NARWHAL_UNUSED NarwhalCollection *params,
+                                                 _NARWHAL_UNUSED NarwhalCollection *fixtures,
+                                                 void *args)
+{
+    NarwhalOutputLimitsModifierArgs *limits = args;
+
+    test->output_limits.enabled = true;
+    test->output_limits.head_size = limits->head_size;
+    test->output_limits.tail_size = limits->tail_size;
+}
+
 /*
  * Cleanup
  */
@@ -601,7 +744,13 @@ void narwhal_free_test(NarwhalTest *test)
     }
     narwhal_free_collection(test->params);
 
-    narwhal_free_collection(test->resources);
+    while (test->constraints->count > 0)
+    {
+        narwhal_collection_pop(test->constraints);
+    }
+    narwhal_free_collection(test->constraints);
+
+    narwhal_free_arena(test->resources);
 
     free(test);
 }
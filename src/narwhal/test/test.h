@@ -7,6 +7,7 @@
 
 #include "narwhal/concat_macro.h"
 #include "narwhal/discovery/discovery.h"
+#include "narwhal/result/result.h"
 #include "narwhal/types.h"
 
 extern NarwhalTest *_narwhal_current_test;
@@ -19,13 +20,18 @@ struct NarwhalTest
     bool only;
     bool skip;
     time_t timeout;
+    NarwhalOutputLimits output_limits;
+    size_t combination_strength;
+    size_t sample_count;
+    time_t sample_budget;
     NarwhalTestGroup *group;
     NarwhalTestFunction function;
-    NarwhalCollection *resources;
+    NarwhalArena *resources;
     NarwhalCollection *fixtures;
     NarwhalCollection *params;
     NarwhalCollection *accessible_fixtures;
     NarwhalCollection *accessible_params;
+    NarwhalCollection *constraints;
     NarwhalTestResult *result;
     NarwhalOutputCapture *output_capture;
     NarwhalResetAllMocksFunction reset_all_mocks;
@@ -42,8 +48,15 @@ void narwhal_run_test(NarwhalTest *test);
 
 void narwhal_free_after_test(NarwhalTest *test, void *resource);
 void auto_free(void *resource);
+void narwhal_unmap_after_test(NarwhalTest *test, void *mapping, size_t size);
 void *narwhal_test_resource(NarwhalTest *test, size_t size);
 void *test_resource(size_t size);
+void *narwhal_test_resource_aligned(NarwhalTest *test, size_t size, size_t alignment);
+void *test_resource_aligned(size_t size, size_t alignment);
+void *narwhal_test_resource_zeroed(NarwhalTest *test, size_t size);
+void *test_resource_zeroed(size_t size);
+void *narwhal_test_resource_realloc(NarwhalTest *test, void *resource, size_t size);
+void *test_resource_realloc(void *resource, size_t size);
 void narwhal_free_test_resources(NarwhalTest *test);
 void narwhal_call_reset_all_mocks(NarwhalTest *test);
 
@@ -78,6 +91,17 @@ void narwhal_timeout_registration_function(NarwhalTest *test,
                                            NarwhalCollection *fixtures,
                                            void *args);
 
+struct NarwhalOutputLimitsModifierArgs
+{
+    size_t head_size;
+    size_t tail_size;
+};
+
+void narwhal_output_limits_registration_function(NarwhalTest *test,
+                                                 NarwhalCollection *params,
+                                                 NarwhalCollection *fixtures,
+                                                 void *args);
+
 void narwhal_free_test(NarwhalTest *test);
 
 #define _NARWHAL_WHEN_NARMOCK_RESET_ALL_MOCKS_IS_1() narmock_reset_all_mocks
@@ -119,4 +143,14 @@ void narwhal_free_test(NarwhalTest *test);
         }                                                                     \
     }
 
+#define OUTPUT_LIMITS(head_size, tail_size)                                                \
+    {                                                                                      \
+        narwhal_output_limits_registration_function, (NarwhalOutputLimitsModifierArgs[]) \
+        {                                                                                  \
+            {                                                                              \
+                head_size, tail_size                                                       \
+            }                                                                              \
+        }                                                                                  \
+    }
+
 #endif
@@ -15,5 +15,6 @@ typedef void (*NarwhalTestFunction)(void);
 typedef void (*NarwhalResetAllMocksFunction)(void);
 
 typedef struct NarwhalTimeoutModifierArgs NarwhalTimeoutModifierArgs;
+typedef struct NarwhalOutputLimitsModifierArgs NarwhalOutputLimitsModifierArgs;
 
 #endif
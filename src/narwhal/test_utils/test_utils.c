@@ -1,3 +1,8 @@
+// memfd_create is a Linux extension that isn't declared with _XOPEN_SOURCE alone
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "narwhal/test_utils/test_utils.h"
 
 #include <errno.h>
@@ -5,6 +10,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "narwhal/test/test.h"
@@ -13,18 +20,78 @@
 NarwhalOutputCapture _narwhal_default_output_capture = { .initialization_phase = true,
                                                          .stdout_backup = -1,
                                                          .stderr_backup = -1,
-                                                         .pipe = { -1, -1 },
+                                                         .file = -1,
                                                          .parent = NULL };
 
+/*
+ * Output files
+ */
+
+int narwhal_create_output_file(void)
+{
+#if defined(MFD_CLOEXEC)
+    int file = memfd_create("narwhal_output", MFD_CLOEXEC);
+
+    if (file != -1 || (errno != ENOSYS && errno != EINVAL))
+    {
+        return file;
+    }
+#endif
+
+    const char *directory = getenv("TMPDIR");
+
+    if (directory == NULL || directory[0] == '\0')
+    {
+        directory = "/tmp";
+    }
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/narwhal_output_XXXXXX", directory);
+
+    int temporary_file = mkstemp(path);
+
+    if (temporary_file != -1)
+    {
+        unlink(path);
+    }
+
+    return temporary_file;
+}
+
+static bool write_all(int file, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(file, data, size);
+
+        if (written == -1 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (written <= 0)
+        {
+            return false;
+        }
+
+        data += written;
+        size -= (size_t)written;
+    }
+
+    return true;
+}
+
 /*
  * Initialize capture
  */
 
 static void initialize_output_capture(NarwhalOutputCapture *capture)
 {
-    if (pipe(capture->pipe) == -1)
+    capture->file = narwhal_create_output_file();
+
+    if (capture->file == -1)
     {
-        fprintf(stderr, "Failed to create capture pipe.\n");
+        fprintf(stderr, "Failed to create capture file.\n");
         exit(EXIT_FAILURE);
     }
 
@@ -34,9 +101,9 @@ static void initialize_output_capture(NarwhalOutputCapture *capture)
     capture->stdout_backup = dup(STDOUT_FILENO);
     capture->stderr_backup = dup(STDERR_FILENO);
 
-    while (dup2(capture->pipe[1], STDOUT_FILENO) == -1 && errno == EINTR)
+    while (dup2(capture->file, STDOUT_FILENO) == -1 && errno == EINTR)
         ;
-    while (dup2(capture->pipe[1], STDERR_FILENO) == -1 && errno == EINTR)
+    while (dup2(capture->file, STDERR_FILENO) == -1 && errno == EINTR)
         ;
 }
 
@@ -46,34 +113,49 @@ static void initialize_output_capture(NarwhalOutputCapture *capture)
 
 static void finalize_output_capture(NarwhalOutputCapture *capture, char **output_buffer)
 {
-    bool terminator_written = write(capture->pipe[1], "", 1) == 1;
-
-    close(capture->pipe[1]);
+    bool terminator_written = write_all(capture->file, "", 1);
 
     dup2(capture->stdout_backup, STDOUT_FILENO);
     dup2(capture->stderr_backup, STDERR_FILENO);
+    close(capture->stdout_backup);
+    close(capture->stderr_backup);
 
-    if (terminator_written)
+    struct stat file_stat;
+    char *mapping = MAP_FAILED;
+
+    if (terminator_written && fstat(capture->file, &file_stat) == 0)
     {
-        FILE *stream = fdopen(capture->pipe[0], "r");
+        mapping = mmap(NULL,
+                       (size_t)file_stat.st_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE,
+                       capture->file,
+                       0);
+    }
 
-        size_t output_length = (size_t)(narwhal_util_read_stream(stream, output_buffer) - 1);
+    if (mapping != MAP_FAILED)
+    {
+        size_t output_length = (size_t)file_stat.st_size - 1;
+        *output_buffer = mapping;
+        narwhal_unmap_after_test(_narwhal_current_test, mapping, output_length + 1);
 
-        if (write(STDOUT_FILENO, *output_buffer, output_length) != (ssize_t)output_length)
+        if (!write_all(STDOUT_FILENO, *output_buffer, output_length))
         {
             fprintf(stderr, "Failed to write captured output to stdout");
         }
-
-        fclose(stream);
     }
     else
     {
-        fprintf(stderr, "Failed to write to capture pipe.\n");
+        fprintf(stderr, "Failed to read capture file.\n");
+
+        *output_buffer = malloc(1);
+        (*output_buffer)[0] = '\0';
+        auto_free(*output_buffer);
     }
 
     _narwhal_current_test->output_capture = capture->parent;
 
-    close(capture->pipe[0]);
+    close(capture->file);
 }
 
 /*
@@ -95,7 +177,6 @@ bool narwhal_capture_output(NarwhalOutputCapture *capture, char **output_buffer)
     else
     {
         finalize_output_capture(capture, output_buffer);
-        auto_free(*output_buffer);
 
         return false;
     }
@@ -12,10 +12,11 @@ struct NarwhalOutputCapture
     bool initialization_phase;
     int stdout_backup;
     int stderr_backup;
-    int pipe[2];
+    int file;
     NarwhalOutputCapture *parent;
 };
 
+int narwhal_create_output_file(void);
 bool narwhal_capture_output(NarwhalOutputCapture *capture, char **output_buffer);
 
 #define CAPTURE_OUTPUT(buffer_name)                                                        \
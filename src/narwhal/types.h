@@ -1,13 +1,19 @@
 #ifndef NARWHAL_TYPES_H
 #define NARWHAL_TYPES_H
 
+#include "narwhal/arena/types.h"
 #include "narwhal/collection/types.h"
+#include "narwhal/combination/types.h"
 #include "narwhal/diff/types.h"
 #include "narwhal/discovery/types.h"
 #include "narwhal/fixture/types.h"
 #include "narwhal/group/types.h"
+#include "narwhal/options/types.h"
+#include "narwhal/output_log/types.h"
 #include "narwhal/param/types.h"
+#include "narwhal/reporter/types.h"
 #include "narwhal/result/types.h"
+#include "narwhal/selector/types.h"
 #include "narwhal/session/types.h"
 #include "narwhal/test/types.h"
 #include "narwhal/test_utils/types.h"
@@ -1,81 +1,267 @@
 #include "narwhal/utils.h"
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 
-size_t narwhal_util_read_stream(FILE *stream, char **output_buffer)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+bool narwhal_is_short_string(const char *string)
+{
+    return strlen(string) < 64 && strchr(string, '\n') == NULL;
+}
+
+int narwhal_min_int(int a, int b)
 {
-    char buffer[256];
-    size_t output_length = 0;
+    return a < b ? a : b;
+}
 
-    size_t read_count = fread(buffer, 1, sizeof(buffer) - 1, stream);
-    buffer[read_count] = '\0';
+size_t narwhal_max_size_t(size_t a, size_t b)
+{
+    return a > b ? a : b;
+}
 
-    if (read_count > 0)
+size_t narwhal_min_size_t(size_t a, size_t b)
+{
+    return a < b ? a : b;
+}
+
+size_t narwhal_count_chars(const char *string, char chr)
+{
+    return narwhal_count_bytes(string, strlen(string), chr);
+}
+
+size_t narwhal_count_bytes(const char *data, size_t size, char chr)
+{
+    size_t count = 0;
+    size_t index = 0;
+
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi8(chr);
+
+    while (index + 32 <= size)
     {
-        *output_buffer = malloc(read_count + 1);
-        memcpy(*output_buffer, buffer, read_count + 1);
-    }
+        __m256i counters = _mm256_setzero_si256();
+
+        for (size_t block = 0; block < 255 && index + 32 <= size; block++, index += 32)
+        {
+            __m256i bytes = _mm256_loadu_si256((const __m256i *)(const void *)(data + index));
+            counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(bytes, needle));
+        }
 
-    output_length = read_count;
+        __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+        count += (size_t)_mm256_extract_epi64(sums, 0) + (size_t)_mm256_extract_epi64(sums, 1) +
+                 (size_t)_mm256_extract_epi64(sums, 2) + (size_t)_mm256_extract_epi64(sums, 3);
+    }
+#elif defined(__SSE2__)
+    __m128i needle = _mm_set1_epi8(chr);
 
-    while (read_count + 1 == sizeof(buffer))
+    while (index + 16 <= size)
     {
-        read_count = fread(buffer, 1, sizeof(buffer) - 1, stream);
-        buffer[read_count] = '\0';
-        output_length += read_count;
+        __m128i counters = _mm_setzero_si128();
+
+        for (size_t block = 0; block < 255 && index + 16 <= size; block++, index += 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(const void *)(data + index));
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(bytes, needle));
+        }
+
+        __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        count += (size_t)_mm_cvtsi128_si32(sums) +
+                 (size_t)_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+    }
+#endif
 
-        *output_buffer = realloc(*output_buffer, output_length + 1);
-        memcpy(*output_buffer + output_length - read_count, buffer, read_count + 1);
+    for (; index < size; index++)
+    {
+        count += data[index] == chr;
     }
 
-    return output_length;
+    return count;
 }
 
-bool narwhal_is_short_string(const char *string)
+size_t narwhal_index_lines(const char *data, size_t size, size_t *line_offsets)
 {
-    return strlen(string) < 64 && strchr(string, '\n') == NULL;
+    size_t line_count = 0;
+    size_t index = 0;
+
+    line_offsets[line_count++] = 0;
+
+#if defined(__AVX2__)
+    __m256i newline = _mm256_set1_epi8('\n');
+
+    for (; index + 32 <= size; index += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(const void *)(data + index));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline));
+
+        for (; mask != 0; mask &= mask - 1)
+        {
+            line_offsets[line_count++] = index + (size_t)__builtin_ctz(mask) + 1;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i newline = _mm_set1_epi8('\n');
+
+    for (; index + 16 <= size; index += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(const void *)(data + index));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline));
+
+        for (; mask != 0; mask &= mask - 1)
+        {
+            line_offsets[line_count++] = index + (size_t)__builtin_ctz(mask) + 1;
+        }
+    }
+#endif
+
+    for (; index < size; index++)
+    {
+        if (data[index] == '\n')
+        {
+            line_offsets[line_count++] = index + 1;
+        }
+    }
+
+    line_offsets[line_count] = size + 1;
+
+    return line_count;
 }
 
-int narwhal_min_int(int a, int b)
+uint64_t narwhal_hash_bytes(const char *data, size_t size)
 {
-    return a < b ? a : b;
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
 }
 
-size_t narwhal_min_size_t(size_t a, size_t b)
+size_t narwhal_common_prefix_length(const char *a, const char *b, size_t length)
 {
-    return a < b ? a : b;
+    size_t index = 0;
+
+#if defined(__AVX2__)
+    for (; index + 32 <= length; index += 32)
+    {
+        __m256i a_bytes = _mm256_loadu_si256((const __m256i *)(const void *)(a + index));
+        __m256i b_bytes = _mm256_loadu_si256((const __m256i *)(const void *)(b + index));
+        unsigned int mask =
+            (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a_bytes, b_bytes));
+
+        if (mask != 0xffffffffu)
+        {
+            return index + (size_t)__builtin_ctz(~mask);
+        }
+    }
+#elif defined(__SSE2__)
+    for (; index + 16 <= length; index += 16)
+    {
+        __m128i a_bytes = _mm_loadu_si128((const __m128i *)(const void *)(a + index));
+        __m128i b_bytes = _mm_loadu_si128((const __m128i *)(const void *)(b + index));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a_bytes, b_bytes));
+
+        if (mask != 0xffffu)
+        {
+            return index + (size_t)__builtin_ctz(~mask);
+        }
+    }
+#endif
+
+    while (index < length && a[index] == b[index])
+    {
+        index++;
+    }
+
+    return index;
 }
 
-size_t narwhal_count_chars(const char *string, char chr)
+size_t narwhal_common_suffix_length(const char *a_end, const char *b_end, size_t length)
 {
-    size_t count = 0;
+    size_t index = 0;
 
-    for (size_t i = 0; string[i] != '\0'; i++)
+#if defined(__AVX2__)
+    for (; index + 32 <= length; index += 32)
     {
-        if (string[i] == chr)
+        __m256i a_bytes = _mm256_loadu_si256((const __m256i *)(const void *)(a_end - index - 32));
+        __m256i b_bytes = _mm256_loadu_si256((const __m256i *)(const void *)(b_end - index - 32));
+        unsigned int mask =
+            (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a_bytes, b_bytes));
+
+        if (mask != 0xffffffffu)
         {
-            count++;
+            return index + (size_t)__builtin_clz(~mask);
         }
     }
+#elif defined(__SSE2__)
+    for (; index + 16 <= length; index += 16)
+    {
+        __m128i a_bytes = _mm_loadu_si128((const __m128i *)(const void *)(a_end - index - 16));
+        __m128i b_bytes = _mm_loadu_si128((const __m128i *)(const void *)(b_end - index - 16));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a_bytes, b_bytes));
 
-    return count;
+        if (mask != 0xffffu)
+        {
+            return index + (size_t)__builtin_clz(~mask << 16);
+        }
+    }
+#endif
+
+    while (index < length && a_end[-(ptrdiff_t)index - 1] == b_end[-(ptrdiff_t)index - 1])
+    {
+        index++;
+    }
+
+    return index;
 }
 
-const char *narwhal_next_line(const char *string)
+size_t narwhal_count_different_bytes(const char *a, const char *b, size_t length)
 {
-    char *next_line = strchr(string, '\n');
+    size_t count = 0;
+    size_t index = 0;
 
-    if (next_line != NULL)
+#if defined(__AVX2__)
+    for (; index + 32 <= length; index += 32)
     {
-        return next_line;
+        __m256i a_bytes = _mm256_loadu_si256((const __m256i *)(const void *)(a + index));
+        __m256i b_bytes = _mm256_loadu_si256((const __m256i *)(const void *)(b + index));
+        unsigned int mask =
+            (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a_bytes, b_bytes));
+
+        count += (size_t)__builtin_popcount(~mask);
     }
-    else
+#elif defined(__SSE2__)
+    for (; index + 16 <= length; index += 16)
+    {
+        __m128i a_bytes = _mm_loadu_si128((const __m128i *)(const void *)(a + index));
+        __m128i b_bytes = _mm_loadu_si128((const __m128i *)(const void *)(b + index));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a_bytes, b_bytes));
+
+        count += (size_t)__builtin_popcount(~mask & 0xffffu);
+    }
+#endif
+
+    for (; index < length; index++)
     {
-        return string + strlen(string);
+        count += a[index] != b[index];
     }
+
+    return count;
+}
+
+const char *narwhal_next_line(const char *string)
+{
+    return string + strcspn(string, "\n");
 }
 
 const char *narwhal_next_lines(const char *string, size_t lines)
@@ -84,7 +270,7 @@ const char *narwhal_next_lines(const char *string, size_t lines)
 
     for (size_t i = 0; i < lines; i++)
     {
-        next_line = narwhal_next_line(next_line) + 1;
+        next_line += strcspn(next_line, "\n") + 1;
     }
 
     return next_line;
@@ -2,13 +2,20 @@
 #define NARWHAL_UTILS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
-size_t narwhal_util_read_stream(FILE *stream, char **buffer);
 bool narwhal_is_short_string(const char *string);
 int narwhal_min_int(int a, int b);
 size_t narwhal_min_size_t(size_t a, size_t b);
+size_t narwhal_max_size_t(size_t a, size_t b);
 size_t narwhal_count_chars(const char *string, char chr);
+size_t narwhal_count_bytes(const char *data, size_t size, char chr);
+size_t narwhal_index_lines(const char *data, size_t size, size_t *line_offsets);
+uint64_t narwhal_hash_bytes(const char *data, size_t size);
+size_t narwhal_common_prefix_length(const char *a, const char *b, size_t length);
+size_t narwhal_common_suffix_length(const char *a_end, const char *b_end, size_t length);
+size_t narwhal_count_different_bytes(const char *a, const char *b, size_t length);
 const char *narwhal_next_line(const char *string);
 const char *narwhal_next_lines(const char *string, size_t lines);
 
@@ -0,0 +1,135 @@
+#include <stdint.h>
+
+#include "narwhal/narwhal.h"
+
+TEST_FIXTURE(sample_arena, NarwhalArena *)
+{
+    *sample_arena = narwhal_new_arena(256);
+
+    CLEANUP_FIXTURE(sample_arena)
+    {
+        narwhal_free_arena(*sample_arena);
+    }
+}
+
+TEST(arena_alignment, sample_arena)
+{
+    GET_FIXTURE(sample_arena);
+
+    narwhal_arena_alloc(sample_arena, 3, 1);
+    void *aligned = narwhal_arena_alloc(sample_arena, 8, 64);
+
+    ASSERT_EQ((uintptr_t)aligned % 64, (uintptr_t)0);
+
+    void *default_aligned = narwhal_arena_alloc(sample_arena, 1, 1);
+
+    ASSERT_EQ((uintptr_t)default_aligned % NARWHAL_ARENA_DEFAULT_ALIGNMENT, (uintptr_t)0);
+}
+
+TEST(arena_invalid_alignment, sample_arena)
+{
+    GET_FIXTURE(sample_arena);
+
+    void *pointer = sample_arena;
+
+    CAPTURE_OUTPUT(output) { pointer = narwhal_arena_alloc(sample_arena, 8, 48); }
+
+    ASSERT_EQ(pointer, NULL);
+    ASSERT_EQ(sample_arena->block, NULL);
+    ASSERT_SUBSTRING(output, "Invalid alignment 48. The alignment must be a power of two.");
+}
+
+TEST(arena_size_overflow, sample_arena)
+{
+    GET_FIXTURE(sample_arena);
+
+    char *before = narwhal_arena_alloc(sample_arena, 16, 1);
+
+    ASSERT_EQ(narwhal_arena_alloc(sample_arena, SIZE_MAX - 8, 1), NULL);
+    ASSERT_EQ(narwhal_arena_realloc(sample_arena, before, SIZE_MAX - 8), NULL);
+
+    char *after = narwhal_arena_alloc(sample_arena, 16, 1);
+
+    ASSERT_EQ((uintptr_t)after - (uintptr_t)before, (uintptr_t)32);
+}
+
+TEST(arena_new_blocks, sample_arena)
+{
+    GET_FIXTURE(sample_arena);
+
+    char *small = narwhal_arena_alloc(sample_arena, 200, 1);
+    char *large = narwhal_arena_alloc(sample_arena, 4096, 1);
+
+    memset(small, 'a', 200);
+    memset(large, 'b', 4096);
+
+    ASSERT_NE((void *)small, (void *)large);
+    ASSERT_EQ(small[199], 'a');
+    ASSERT_EQ(large[4095], 'b');
+}
+
+TEST(arena_realloc, sample_arena)
+{
+    GET_FIXTURE(sample_arena);
+
+    char *buffer = narwhal_arena_realloc(sample_arena, NULL, 4);
+    memcpy(buffer, "abc", 4);
+
+    char *grown = narwhal_arena_realloc(sample_arena, buffer, 8);
+
+    ASSERT_EQ((void *)grown, (void *)buffer);
+
+    narwhal_arena_alloc(sample_arena, 1, 1);
+    char *moved = narwhal_arena_realloc(sample_arena, grown, 1024);
+
+    ASSERT_NE((void *)moved, (void *)grown);
+    ASSERT_EQ(moved, "abc");
+}
+
+TEST(arena_reset, sample_arena)
+{
+    GET_FIXTURE(sample_arena);
+
+    void *first = narwhal_arena_alloc(sample_arena, 16, 1);
+    narwhal_arena_alloc(sample_arena, 4096, 1);
+    narwhal_arena_adopt(sample_arena, malloc(32));
+
+    narwhal_arena_reset(sample_arena);
+
+    ASSERT_EQ(sample_arena->adopted, NULL);
+    ASSERT_EQ(narwhal_arena_alloc(sample_arena, 16, 1), first);
+}
+
+TEST(arena_test_resource_zeroed)
+{
+    unsigned char *buffer = test_resource_zeroed(128);
+
+    for (size_t i = 0; i < 128; i++)
+    {
+        ASSERT_EQ(buffer[i], 0);
+    }
+}
+
+TEST(arena_test_resource_realloc)
+{
+    int *numbers = NULL;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        numbers = test_resource_realloc(numbers, (size_t)(i + 1) * sizeof(int));
+        numbers[i] = i;
+        test_resource(7);
+    }
+
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(numbers[i], i);
+    }
+}
+
+TEST(arena_test_resource_aligned)
+{
+    void *buffer = test_resource_aligned(100, 4096);
+
+    ASSERT_EQ((uintptr_t)buffer % 4096, (uintptr_t)0);
+}
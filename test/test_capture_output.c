@@ -40,6 +40,36 @@ TEST(capture_output_loop)
     ASSERT_EQ(output, "0123456789\n");
 }
 
+TEST(capture_output_large)
+{
+    size_t line_count = 100000;
+
+    CAPTURE_OUTPUT(output)
+    {
+        for (size_t i = 0; i < line_count; i++)
+        {
+            printf("line %06zu\n", i);
+        }
+    }
+
+    ASSERT_EQ(strlen(output), line_count * 12);
+    ASSERT_EQ(strncmp(output + 12 * 54321, "line 054321\n", 12), 0);
+}
+
+TEST(capture_output_nested)
+{
+    CAPTURE_OUTPUT(outer)
+    {
+        printf("before ");
+
+        CAPTURE_OUTPUT(inner) { printf("inside"); }
+
+        printf(" after [%s]", inner);
+    }
+
+    ASSERT_EQ(outer, "before inside after [inside]");
+}
+
 #define DISABLE_TEST_DISCOVERY 1
 
 TEST(meta_capture_output_transparent)
@@ -66,6 +96,16 @@ TEST(meta_capture_output_transparent_interrupt)
     printf(" after\n");
 }
 
+TEST(meta_output_limits, OUTPUT_LIMITS(12, 12))
+{
+    for (size_t i = 0; i < 10000; i++)
+    {
+        printf("line %06zu\n", i);
+    }
+
+    FAIL();
+}
+
 #undef DISABLE_TEST_DISCOVERY
 
 TEST_PARAM(meta_output_capture_test,
@@ -87,3 +127,32 @@ TEST(run_meta_output_capture_test, meta_output_capture_test)
     ASSERT_EQ(status_code, EXIT_FAILURE);
     ASSERT_SUBSTRING(test_output, meta_output_capture_test.output);
 }
+
+TEST(run_meta_output_limits)
+{
+    CAPTURE_OUTPUT(test_output) { RUN_TESTS(meta_output_limits); }
+
+    ASSERT_SUBSTRING(test_output, "line 000000");
+    ASSERT_SUBSTRING(test_output, "[... 119976 bytes elided ...]");
+    ASSERT_SUBSTRING(test_output, "line 009999");
+    ASSERT_NOT_SUBSTRING(test_output, "line 005000");
+}
+
+TEST(capture_output_without_tmpdir)
+{
+    setenv("TMPDIR", "/nonexistent/narwhal", 1);
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(output)
+    {
+        printf("in memory");
+        status_code = RUN_TESTS(meta_capture_output_transparent);
+    }
+
+    unsetenv("TMPDIR");
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_SUBSTRING(output, "in memory");
+    ASSERT_SUBSTRING(output, "before inside after\n");
+}
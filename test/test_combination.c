@@ -0,0 +1,264 @@
+#include "narwhal/narwhal.h"
+
+TEST_PARAM(meta_first, int, { 0, 1, 2 });
+TEST_PARAM(meta_second, int, { 0, 1, 2 });
+TEST_PARAM(meta_third, int, { 0, 1, 2 });
+TEST_PARAM(meta_fourth, int, { 0, 1, 2 });
+
+TEST_CONSTRAINT(different_first_and_second)
+{
+    GET_PARAM(meta_first);
+    GET_PARAM(meta_second);
+
+    if (meta_first == meta_second)
+    {
+        REJECT_COMBINATION();
+    }
+}
+
+static size_t collect_combinations(const NarwhalOptions *options,
+                                   NarwhalTestModifierRegistration *modifiers,
+                                   size_t modifier_count,
+                                   size_t rows[][4])
+{
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = options;
+
+    NarwhalTest *test = narwhal_new_test(
+        "meta_combination_test", __FILE__, __LINE__, NULL, modifiers, modifier_count, NULL);
+
+    NarwhalParamCombinations *combinations = narwhal_new_param_combinations(test);
+    size_t row_count = 0;
+
+    while (narwhal_param_combinations_next(combinations))
+    {
+        size_t param_index = 0;
+
+        NarwhalTestParam *test_param;
+        NARWHAL_EACH(test_param, test->params)
+        {
+            rows[row_count][param_index++] = test_param->index;
+        }
+
+        row_count++;
+    }
+
+    narwhal_free_param_combinations(combinations);
+    narwhal_free_test(test);
+
+    _narwhal_current_options = previous_options;
+
+    return row_count;
+}
+
+static bool tuple_covered(size_t rows[][4],
+                          size_t row_count,
+                          const size_t *members,
+                          const size_t *values,
+                          size_t strength)
+{
+    for (size_t row = 0; row < row_count; row++)
+    {
+        bool matched = true;
+
+        for (size_t i = 0; i < strength; i++)
+        {
+            matched = matched && rows[row][members[i]] == values[i];
+        }
+
+        if (matched)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TEST(combinations_full_product)
+{
+    size_t rows[81][4];
+
+    size_t row_count = collect_combinations(
+        &_narwhal_default_options,
+        (NarwhalTestModifierRegistration[]){ meta_first, meta_second, meta_third, meta_fourth },
+        4,
+        rows);
+
+    ASSERT_EQ(row_count, (size_t)81);
+    ASSERT_EQ(rows[1][3], (size_t)1);
+    ASSERT_EQ(rows[80][0], (size_t)2);
+}
+
+TEST(combinations_pairwise)
+{
+    size_t rows[81][4];
+
+    size_t row_count = collect_combinations(
+        &_narwhal_default_options,
+        (NarwhalTestModifierRegistration[]){
+            meta_first, meta_second, meta_third, meta_fourth, PAIRWISE },
+        5,
+        rows);
+
+    ASSERT_LT(row_count, (size_t)16);
+
+    for (size_t first = 0; first < 4; first++)
+    {
+        for (size_t second = first + 1; second < 4; second++)
+        {
+            for (size_t value = 0; value < 9; value++)
+            {
+                size_t members[] = { first, second };
+                size_t values[] = { value / 3, value % 3 };
+
+                ASSERT(tuple_covered(rows, row_count, members, values, 2));
+            }
+        }
+    }
+}
+
+TEST(combinations_three_wise)
+{
+    size_t rows[81][4];
+
+    size_t row_count = collect_combinations(
+        &_narwhal_default_options,
+        (NarwhalTestModifierRegistration[]){
+            meta_first, meta_second, meta_third, meta_fourth, N_WISE(3) },
+        5,
+        rows);
+
+    ASSERT_LT(row_count, (size_t)81);
+
+    for (size_t skipped = 0; skipped < 4; skipped++)
+    {
+        size_t members[3];
+        size_t member_count = 0;
+
+        for (size_t member = 0; member < 4; member++)
+        {
+            if (member != skipped)
+            {
+                members[member_count++] = member;
+            }
+        }
+
+        for (size_t value = 0; value < 27; value++)
+        {
+            size_t values[] = { value / 9, value / 3 % 3, value % 3 };
+
+            ASSERT(tuple_covered(rows, row_count, members, values, 3));
+        }
+    }
+}
+
+TEST(combinations_constraint)
+{
+    size_t rows[81][4];
+
+    size_t product_count = collect_combinations(
+        &_narwhal_default_options,
+        (NarwhalTestModifierRegistration[]){
+            meta_first, meta_second, meta_third, different_first_and_second },
+        4,
+        rows);
+
+    ASSERT_EQ(product_count, (size_t)18);
+
+    size_t row_count = collect_combinations(
+        &_narwhal_default_options,
+        (NarwhalTestModifierRegistration[]){ meta_first,
+                                             meta_second,
+                                             meta_third,
+                                             meta_fourth,
+                                             PAIRWISE,
+                                             different_first_and_second },
+        6,
+        rows);
+
+    for (size_t row = 0; row < row_count; row++)
+    {
+        ASSERT_NE(rows[row][0], rows[row][1]);
+    }
+
+    for (size_t value = 0; value < 9; value++)
+    {
+        size_t members[] = { 0, 2 };
+        size_t values[] = { value / 3, value % 3 };
+
+        ASSERT(tuple_covered(rows, row_count, members, values, 2));
+    }
+}
+
+static size_t count_distinct_rows(size_t rows[][4], size_t row_count)
+{
+    size_t distinct = 0;
+
+    for (size_t row = 0; row < row_count; row++)
+    {
+        bool duplicate = false;
+
+        for (size_t other = 0; other < row && !duplicate; other++)
+        {
+            duplicate = memcmp(rows[row], rows[other], sizeof(rows[row])) == 0;
+        }
+
+        distinct += !duplicate;
+    }
+
+    return distinct;
+}
+
+TEST(combinations_sample_count)
+{
+    size_t rows[81][4];
+    size_t other_rows[81][4];
+    size_t exhaustive_rows[81][4];
+
+    NarwhalOptions options = _narwhal_default_options;
+    options.seed = 42;
+
+    size_t row_count = collect_combinations(
+        &options,
+        (NarwhalTestModifierRegistration[]){
+            meta_first, meta_second, meta_third, meta_fourth, SAMPLE_COUNT(10) },
+        5,
+        rows);
+
+    size_t other_row_count = collect_combinations(
+        &options,
+        (NarwhalTestModifierRegistration[]){
+            meta_first, meta_second, meta_third, meta_fourth, SAMPLE_COUNT(10) },
+        5,
+        other_rows);
+
+    size_t exhaustive_count = collect_combinations(
+        &options,
+        (NarwhalTestModifierRegistration[]){
+            meta_first, meta_second, meta_third, meta_fourth, SAMPLE_COUNT(100) },
+        5,
+        exhaustive_rows);
+
+    ASSERT_EQ(row_count, (size_t)10);
+    ASSERT_EQ(other_row_count, (size_t)10);
+    ASSERT_EQ(count_distinct_rows(rows, row_count), (size_t)10);
+    ASSERT_MEMORY(rows, other_rows, 10 * sizeof(*rows));
+
+    ASSERT_EQ(exhaustive_count, (size_t)81);
+    ASSERT_EQ(count_distinct_rows(exhaustive_rows, exhaustive_count), (size_t)81);
+}
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_sampled_test, meta_first, meta_second, SAMPLE_COUNT(3)) {}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST(combinations_report_seed)
+{
+    CAPTURE_OUTPUT(output) { RUN_TESTS(meta_sampled_test); }
+
+    ASSERT_SUBSTRING(output, "3 total");
+    ASSERT_SUBSTRING(output, "Seed:");
+}
@@ -0,0 +1,114 @@
+#include "narwhal/narwhal.h"
+
+static size_t round_trip(const char *input, size_t size)
+{
+    char *compressed = malloc(narwhal_compress_bound(size));
+    auto_free(compressed);
+
+    size_t compressed_size = narwhal_compress(input, size, compressed);
+
+    char *decompressed = malloc(size + 1);
+    auto_free(decompressed);
+
+    if (!narwhal_decompress(compressed, compressed_size, decompressed, size) ||
+        memcmp(input, decompressed, size) != 0)
+    {
+        return SIZE_MAX;
+    }
+
+    return compressed_size;
+}
+
+TEST(compression_small_inputs)
+{
+    ASSERT_EQ(round_trip("", 0), (size_t)1);
+    ASSERT_EQ(round_trip("a", 1), (size_t)2);
+    ASSERT_EQ(round_trip("abcdefghijklmnopqrstuvwxyz", 26), (size_t)28);
+}
+
+TEST(compression_repetitive_input)
+{
+    size_t size = 1 << 20;
+    char *input = malloc(size);
+    auto_free(input);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        input[i] = (char)('a' + (i / 7) % 3);
+    }
+
+    size_t compressed_size = round_trip(input, size);
+
+    ASSERT_NE(compressed_size, SIZE_MAX);
+    ASSERT_LT(compressed_size, size / 100);
+}
+
+TEST(compression_random_input)
+{
+    size_t size = 100000;
+    char *input = malloc(size);
+    auto_free(input);
+
+    uint64_t state = 88172645463325252ULL;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        input[i] = i % 1000 < 500 ? (char)state : (char)('0' + i % 10);
+    }
+
+    size_t compressed_size = round_trip(input, size);
+
+    ASSERT_NE(compressed_size, SIZE_MAX);
+    ASSERT_LE(compressed_size, narwhal_compress_bound(size));
+}
+
+TEST(compression_invalid_input)
+{
+    char output[16];
+
+    ASSERT(!narwhal_decompress("\xf0", 1, output, sizeof(output)));
+    ASSERT(!narwhal_decompress("\x10" "a\x05\x00", 4, output, sizeof(output)));
+    ASSERT(!narwhal_decompress("\x20" "ab", 3, output, 1));
+}
+
+TEST(compression_test_result)
+{
+    NarwhalTestResult *test_result = narwhal_new_test_result();
+
+    const char *original = "line\nline\nline\nline\nline\nline\nline\nline\nline\nline\n"
+                           "line\nline\nline\nline\nline\nline\nline\nline\nline\nline\n"
+                           "line\nline\nline\nline\nline\nline\nline\nline\nline\nline\n"
+                           "line\nline\nline\nline\nline\nline\nline\nline\nline\nline\n"
+                           "line\nline\nline\nline\nline\nline\nline\nline\nline\nline\n"
+                           "line\nline\nline\nline\nline\nline\nline\nline\nline\nend\n";
+    test_result->diff_original_size = strlen(original) + 1;
+    test_result->diff_original = malloc(test_result->diff_original_size);
+    memcpy(test_result->diff_original, original, test_result->diff_original_size);
+
+    test_result->diff_modified_size = 4;
+    test_result->diff_modified = malloc(4);
+    memcpy(test_result->diff_modified, "foo", 4);
+
+    narwhal_compress_test_result(test_result);
+
+    bool compressed = test_result->compressed;
+    size_t original_compressed_size = test_result->diff_original_compressed_size;
+    size_t modified_compressed_size = test_result->diff_modified_compressed_size;
+
+    narwhal_decompress_test_result(test_result);
+
+    bool matches_original = strcmp(test_result->diff_original, original) == 0;
+    bool matches_modified = strcmp(test_result->diff_modified, "foo") == 0;
+
+    narwhal_free_test_result(test_result);
+
+    ASSERT(compressed);
+    ASSERT_GT(original_compressed_size, (size_t)0);
+    ASSERT_LT(original_compressed_size, strlen(original));
+    ASSERT_EQ(modified_compressed_size, (size_t)0);
+    ASSERT(matches_original);
+    ASSERT(matches_modified);
+}
@@ -1,5 +1,9 @@
+#include <sys/time.h>
+
 #include "narwhal/narwhal.h"
 
+#include "narwhal/utils.h"
+
 TEST(diff_matrix_initialization)
 {
     NarwhalDiffMatrix *diff_matrix = narwhal_new_diff_matrix(16, 42);
@@ -112,6 +116,28 @@ TEST(diff_strings_deleted)
     ASSERT_EQ(diff.chunks[1].modified_start, diff.chunks[1].modified_end);
 }
 
+TEST(diff_strings_common_prefix_and_suffix)
+{
+    const char *original = "the same long prefix, something, and the same long suffix";
+    const char *modified = "the same long prefix, everything, and the same long suffix";
+
+    ASSERT_EQ(narwhal_common_prefix_length(original, modified, strlen(original)), (size_t)22);
+    ASSERT_EQ(narwhal_common_suffix_length(original + strlen(original),
+                                           modified + strlen(modified),
+                                           strlen(original)),
+              (size_t)31);
+
+    NarwhalDiff diff = narwhal_diff_strings(original, modified);
+    auto_free(diff.chunks);
+
+    ASSERT_EQ(diff.size, (size_t)3);
+    ASSERT_EQ(diff.chunks[1].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_REPLACED);
+    ASSERT_EQ(diff.chunks[1].original_start, (size_t)22);
+    ASSERT_EQ(diff.chunks[1].original_end, (size_t)26);
+    ASSERT_EQ(diff.chunks[1].modified_start, (size_t)22);
+    ASSERT_EQ(diff.chunks[1].modified_end, (size_t)27);
+}
+
 TEST(diff_lines_matched)
 {
     NarwhalDiff diff = narwhal_diff_lines("hello\nworld", "hello\nworld");
@@ -152,3 +178,341 @@ TEST(diff_lines_deleted)
     ASSERT_EQ(diff.chunks[1].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_DELETED);
     ASSERT_EQ(diff.chunks[1].modified_start, diff.chunks[1].modified_end);
 }
+
+TEST(diff_strings_large)
+{
+    size_t length = 50000;
+
+    char *original = malloc(length + 1);
+    auto_free(original);
+    char *modified = malloc(length + 1);
+    auto_free(modified);
+
+    for (size_t i = 0; i < length; i++)
+    {
+        original[i] = (char)('a' + i * 7 % 26);
+    }
+    original[length] = '\0';
+
+    strcpy(modified, original);
+    modified[length / 2] = '!';
+
+    NarwhalDiff diff = narwhal_diff_strings(original, modified);
+    auto_free(diff.chunks);
+
+    ASSERT_EQ(diff.size, (size_t)3);
+    ASSERT_EQ(diff.chunks[0].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+    ASSERT_EQ(diff.chunks[1].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_REPLACED);
+    ASSERT_EQ(diff.chunks[1].original_start, length / 2);
+    ASSERT_EQ(diff.chunks[1].original_end, length / 2 + 1);
+    ASSERT_EQ(diff.chunks[1].modified_start, length / 2);
+    ASSERT_EQ(diff.chunks[1].modified_end, length / 2 + 1);
+    ASSERT_EQ(diff.chunks[2].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+}
+
+TEST(diff_lines_interleaved)
+{
+    NarwhalDiff diff = narwhal_diff_lines("a\nb\nc\nd\ne", "a\nc\nd\nx\ne\nf");
+    auto_free(diff.chunks);
+
+    ASSERT_EQ(diff.size, (size_t)6);
+    ASSERT_EQ(diff.chunks[0].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+    ASSERT_EQ(diff.chunks[1].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_DELETED);
+    ASSERT_EQ(diff.chunks[1].original_start, (size_t)1);
+    ASSERT_EQ(diff.chunks[2].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+    ASSERT_EQ(diff.chunks[3].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_ADDED);
+    ASSERT_EQ(diff.chunks[3].modified_start, (size_t)3);
+    ASSERT_EQ(diff.chunks[4].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+    ASSERT_EQ(diff.chunks[5].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_ADDED);
+}
+
+TEST(diff_lines_large)
+{
+    size_t line_count = 20000;
+
+    char *original = malloc(line_count * 8 + 1);
+    auto_free(original);
+    char *modified = malloc(line_count * 8 + 1);
+    auto_free(modified);
+
+    char *original_end = original;
+    char *modified_end = modified;
+
+    for (size_t i = 0; i < line_count; i++)
+    {
+        original_end += sprintf(original_end, "%s%zu", i > 0 ? "\n" : "", i % 100);
+
+        if (i != 7000 && i != 13000)
+        {
+            modified_end += sprintf(modified_end, "%s%zu", i > 0 ? "\n" : "", i % 100);
+        }
+    }
+
+    NarwhalDiff diff = narwhal_diff_lines(original, modified);
+    auto_free(diff.chunks);
+
+    ASSERT_EQ(diff.size, (size_t)5);
+    ASSERT_EQ(diff.chunks[1].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_DELETED);
+    ASSERT_EQ(diff.chunks[3].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_DELETED);
+    ASSERT_EQ(diff.chunks[4].original_end, line_count);
+    ASSERT_EQ(diff.chunks[4].modified_end, line_count - 2);
+}
+
+TEST(diff_limits)
+{
+    NarwhalDiff diff;
+
+    NarwhalDiffLimits size_limits = { .max_size = 8, .max_edits = 0, .max_milliseconds = 0 };
+    ASSERT_EQ(narwhal_diff_lines_limited(
+                  "hello", "world", NARWHAL_DIFF_ALGORITHM_MYERS, &size_limits, &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_SIZE);
+    ASSERT_EQ(diff.size, (size_t)0);
+
+    NarwhalDiffLimits edit_limits = { .max_size = 0, .max_edits = 2, .max_milliseconds = 0 };
+    ASSERT_EQ(narwhal_diff_strings_limited(
+                  "abcdef", 6, "badcfe", 6, NARWHAL_DIFF_ALGORITHM_MYERS, &edit_limits, &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_EDITS);
+    ASSERT_EQ(diff.size, (size_t)0);
+
+    NarwhalDiffLimits loose_limits = { .max_size = 64, .max_edits = 8, .max_milliseconds = 1000 };
+    ASSERT_EQ(narwhal_diff_strings_limited(
+                  "abcdef", 6, "abXdef", 6, NARWHAL_DIFF_ALGORITHM_MYERS, &loose_limits, &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_NONE);
+    auto_free(diff.chunks);
+    ASSERT_EQ(diff.size, (size_t)3);
+}
+
+TEST(diff_limits_options)
+{
+    NarwhalOptions *options = narwhal_new_options();
+
+    char *argv[] = {
+        "run_tests", "--diff-max-size=0", "--diff-max-edits=12", "--diff-timeout=50"
+    };
+    bool parsed = narwhal_parse_options(options, 4, argv);
+
+    NarwhalDiffLimits limits = options->diff_limits;
+    narwhal_free_options(options);
+
+    ASSERT(parsed);
+    ASSERT_EQ(limits.max_size, (size_t)0);
+    ASSERT_EQ(limits.max_edits, (size_t)12);
+    ASSERT_EQ(limits.max_milliseconds, (size_t)50);
+}
+
+TEST_PARAM(meta_invalid_number_option,
+           char *,
+           { "--diff-max-size=-1",
+             "--diff-max-edits= 5",
+             "--diff-timeout=+5",
+             "--diff-timeout=99999999999999999999999" });
+
+TEST(diff_limits_invalid_options, meta_invalid_number_option)
+{
+    GET_PARAM(meta_invalid_number_option);
+
+    NarwhalOptions *options = narwhal_new_options();
+
+    char *argv[] = { "run_tests", meta_invalid_number_option };
+    bool parsed = true;
+
+    CAPTURE_OUTPUT(output) { parsed = narwhal_parse_options(options, 2, argv); }
+
+    narwhal_free_options(options);
+
+    ASSERT(!parsed);
+    ASSERT_SUBSTRING(output, "Invalid diff ");
+}
+
+TEST(diff_lines_patience)
+{
+    const char *original = "int f()\n{\n    return 1;\n}\n\nint g()\n{\n    return 2;\n}";
+    const char *modified = "int g()\n{\n    return 2;\n}\n\nint f()\n{\n    return 1;\n}";
+
+    NarwhalDiff diff;
+    ASSERT_EQ(narwhal_diff_lines_limited(
+                  original, modified, NARWHAL_DIFF_ALGORITHM_PATIENCE, NULL, &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_NONE);
+    auto_free(diff.chunks);
+
+    ASSERT_EQ(diff.size, (size_t)4);
+    ASSERT_EQ(diff.chunks[0].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_DELETED);
+    ASSERT_EQ(diff.chunks[0].original_end, (size_t)5);
+    ASSERT_EQ(diff.chunks[1].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+    ASSERT_EQ(diff.chunks[1].original_start, (size_t)5);
+    ASSERT_EQ(diff.chunks[1].modified_start, (size_t)0);
+    ASSERT_EQ(diff.chunks[2].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_ADDED);
+    ASSERT_EQ(diff.chunks[3].type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+}
+
+TEST(diff_strings_bit_parallel)
+{
+    char original[512];
+    char modified[512];
+
+    for (size_t i = 0; i < 500; i++)
+    {
+        original[i] = (char)('a' + i * 7 % 26);
+        modified[i] = i % 50 == 25 ? '_' : original[i];
+    }
+
+    original[500] = '\0';
+    modified[500] = '\0';
+
+    NarwhalDiff diff;
+    ASSERT_EQ(narwhal_diff_strings_limited(
+                  original, 500, modified, 500, NARWHAL_DIFF_ALGORITHM_BIT_PARALLEL, NULL, &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_NONE);
+    auto_free(diff.chunks);
+
+    ASSERT_EQ(diff.size, (size_t)21);
+
+    for (size_t i = 0; i < diff.size; i++)
+    {
+        NarwhalDiffChunk *chunk = &diff.chunks[i];
+
+        if (i % 2 == 0)
+        {
+            ASSERT_EQ(chunk->type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_MATCHED);
+        }
+        else
+        {
+            ASSERT_EQ(chunk->type, (NarwhalDiffChunkType)NARWHAL_DIFF_CHUNK_TYPE_REPLACED);
+            ASSERT_EQ(chunk->original_start, (i / 2) * 50 + 25);
+            ASSERT_EQ(chunk->modified_end, (i / 2) * 50 + 26);
+        }
+    }
+}
+
+static char *unrelated_string(size_t length, uint32_t seed)
+{
+    char *string = test_resource(length + 1);
+
+    for (size_t i = 0; i < length; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        string[i] = (char)('a' + (seed >> 16) % 26);
+    }
+
+    string[length] = '\0';
+
+    return string;
+}
+
+static double milliseconds_since(struct timeval start)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    return (double)(now.tv_sec - start.tv_sec) * 1000 +
+           (double)(now.tv_usec - start.tv_usec) / 1000;
+}
+
+TEST(diff_bit_parallel_limits)
+{
+    size_t length = 1024 * 1024;
+    char *original = unrelated_string(length, 1);
+    char *modified = unrelated_string(length, 2);
+
+    NarwhalDiff diff;
+
+    NarwhalDiffLimits edit_limits = { .max_size = 0, .max_edits = 1000, .max_milliseconds = 0 };
+    ASSERT_EQ(narwhal_diff_strings_limited(original,
+                                           length,
+                                           modified,
+                                           length / 2,
+                                           NARWHAL_DIFF_ALGORITHM_BIT_PARALLEL,
+                                           &edit_limits,
+                                           &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_EDITS);
+    ASSERT_EQ(diff.size, (size_t)0);
+
+    NarwhalDiffLimits time_limits = { .max_size = 0, .max_edits = 0, .max_milliseconds = 20 };
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+
+    ASSERT_EQ(narwhal_diff_strings_limited(original,
+                                           length,
+                                           modified,
+                                           length,
+                                           NARWHAL_DIFF_ALGORITHM_BIT_PARALLEL,
+                                           &time_limits,
+                                           &diff),
+              (NarwhalDiffLimit)NARWHAL_DIFF_LIMIT_TIME);
+    ASSERT_EQ(diff.size, (size_t)0);
+    ASSERT_LT(milliseconds_since(start), 500.0);
+}
+
+TEST(output_diff_timeout)
+{
+    size_t length = 1024 * 1024;
+    char *original = unrelated_string(length, 1);
+    char *modified = unrelated_string(length, 2);
+
+    NarwhalOptions *options = narwhal_new_options();
+    options->diff_limits.max_milliseconds = 20;
+
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = options;
+
+    char *output = NULL;
+    size_t output_size = 0;
+    FILE *stream = open_memstream(&output, &output_size);
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+
+    narwhal_output_diff(stream, original, modified);
+
+    double elapsed = milliseconds_since(start);
+
+    fclose(stream);
+    auto_free(output);
+
+    _narwhal_current_options = previous_options;
+    narwhal_free_options(options);
+
+    ASSERT_LT(elapsed, 500.0);
+    ASSERT_SUBSTRING(output, original);
+    ASSERT_SUBSTRING(output, modified);
+}
+
+TEST(diff_line_index)
+{
+    size_t size = 20000;
+    char *data = malloc(size);
+    auto_free(data);
+
+    size_t *line_offsets = malloc((size + 1) * sizeof(size_t));
+    auto_free(line_offsets);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = i % 7 == 3 || i % 61 == 0 ? '\n' : (char)('a' + i % 26);
+    }
+
+    for (size_t length = 0; length < size; length = length * 3 + 1)
+    {
+        size_t newlines = 0;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            newlines += data[i] == '\n';
+        }
+
+        ASSERT_EQ(narwhal_count_bytes(data, length, '\n'), newlines);
+        ASSERT_EQ(narwhal_index_lines(data, length, line_offsets), newlines + 1);
+
+        for (size_t line = 1; line <= newlines; line++)
+        {
+            ASSERT_EQ(data[line_offsets[line] - 1], '\n');
+            ASSERT_EQ(narwhal_count_bytes(data, line_offsets[line], '\n'), line);
+        }
+
+        ASSERT_EQ(line_offsets[newlines + 1], length + 1);
+    }
+
+    ASSERT_EQ(narwhal_count_bytes(data, size, '\n'), (size_t)3138);
+    ASSERT_EQ(narwhal_count_chars("a\nb\n\nc", '\n'), (size_t)3);
+}
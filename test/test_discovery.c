@@ -0,0 +1,96 @@
+#include "narwhal/narwhal.h"
+
+DECLARE_TEST(meta_undiscovered_first);
+DECLARE_TEST(meta_undiscovered_second);
+
+static size_t count_descriptors(const char *name)
+{
+    const NarwhalTestDescriptor *descriptors;
+    size_t descriptor_count = narwhal_discovered_tests(&descriptors);
+    size_t count = 0;
+
+    for (size_t i = 0; i < descriptor_count; i++)
+    {
+        if (strcmp(descriptors[i].name, name) == 0)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+TEST(discovery_descriptors_unique)
+{
+    const NarwhalTestDescriptor *descriptors;
+    size_t descriptor_count = narwhal_discovered_tests(&descriptors);
+
+    ASSERT_GT(descriptor_count, (size_t)0);
+
+    for (size_t i = 0; i < descriptor_count; i++)
+    {
+        ASSERT_NE(descriptors[i].test_handle, NULL);
+        ASSERT_EQ(count_descriptors(descriptors[i].name), (size_t)1);
+    }
+
+    ASSERT_EQ(count_descriptors("discovery_descriptors_unique"), (size_t)1);
+    ASSERT_EQ(count_descriptors("discovery_line_order"), (size_t)1);
+}
+
+TEST(discovery_line_order)
+{
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = &_narwhal_default_options;
+
+    NarwhalTestGroup *root_group = narwhal_discover_tests();
+
+    _narwhal_current_options = previous_options;
+
+    const NarwhalTestDescriptor *descriptors;
+    size_t descriptor_count = narwhal_discovered_tests(&descriptors);
+
+    size_t test_count = root_group->tests->count;
+    size_t file_test_count = 0;
+    size_t previous_line = 0;
+    bool ordered = true;
+
+    NarwhalTest *test;
+    NARWHAL_EACH(test, root_group->tests)
+    {
+        if (strcmp(test->filename, __FILE__) == 0)
+        {
+            ordered = ordered && test->line_number > previous_line;
+            previous_line = test->line_number;
+            file_test_count++;
+        }
+    }
+
+    narwhal_free_test_group(root_group);
+
+    ASSERT_EQ(test_count, descriptor_count);
+    ASSERT_EQ(file_test_count, (size_t)3);
+    ASSERT(ordered);
+}
+
+TEST(discovery_disabled_file)
+{
+    NarwhalGroupItemRegistration first = meta_undiscovered_first;
+    NarwhalGroupItemRegistration second = meta_undiscovered_second;
+
+    const NarwhalTestDescriptor *descriptors;
+    size_t descriptor_count = narwhal_discovered_tests(&descriptors);
+
+    for (size_t i = 0; i < descriptor_count; i++)
+    {
+        ASSERT_NE(descriptors[i].test_handle, first);
+        ASSERT_NE(descriptors[i].test_handle, second);
+        ASSERT(strstr(descriptors[i].filename, "test_discovery_disabled.c") == NULL);
+    }
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(output) { status_code = RUN_TESTS(first, second); }
+
+    ASSERT_EQ(status_code, EXIT_SUCCESS);
+    ASSERT_SUBSTRING(output, "2 passed");
+}
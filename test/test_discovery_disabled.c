@@ -0,0 +1,7 @@
+#include "narwhal/narwhal.h"
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_undiscovered_first) {}
+
+TEST(meta_undiscovered_second) {}
@@ -0,0 +1,61 @@
+#include "narwhal/narwhal.h"
+
+TEST(hexdump_rows)
+{
+    const uint8_t buffer[] = { 'a', 'b', 'c', 0, 1, 2, 'd' };
+
+    ASSERT_EQ(narwhal_hexdump(buffer, sizeof(buffer), 4),
+              "000000  61 62 63 00  abc.\n"
+              "000004  01 02 64 --  ..d ");
+}
+
+TEST(hexdump_mismatches)
+{
+    size_t size = 1 << 20;
+    uint8_t *expected = calloc(size, 1);
+    uint8_t *actual = calloc(size, 1);
+    auto_free(expected);
+    auto_free(actual);
+
+    actual[0x100] = 'x';
+    actual[0x101] = 'y';
+    actual[0x80000] = 'z';
+
+    char *actual_dump;
+    char *expected_dump;
+    narwhal_hexdump_mismatches(actual, expected, size, 16, 1, &actual_dump, &expected_dump);
+
+    ASSERT_EQ(expected_dump,
+              "3 differing bytes at offsets 000100, 080000\n"
+              "...  240 identical bytes\n"
+              "0000F0  00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00  ................\n"
+              "000100  00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00  ................\n"
+              "000110  00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00  ................\n"
+              "...  523984 identical bytes\n"
+              "07FFF0  00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00  ................\n"
+              "080000  00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00  ................\n"
+              "080010  00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00  ................\n"
+              "...  524256 identical bytes");
+    ASSERT_SUBSTRING(actual_dump,
+                     "000100  78 79 00 00 00 00 00 00 00 00 00 00 00 00 00 00  xy..............");
+}
+
+TEST(hexdump_mismatches_truncated)
+{
+    uint8_t expected[NARWHAL_HEXDUMP_MAX_REGIONS * 64] = { 0 };
+    uint8_t actual[NARWHAL_HEXDUMP_MAX_REGIONS * 64] = { 0 };
+
+    for (size_t i = 0; i < sizeof(actual); i += 32)
+    {
+        actual[i] = 1;
+    }
+
+    char *actual_dump;
+    char *expected_dump;
+    narwhal_hexdump_mismatches(
+        actual, expected, sizeof(actual), 16, 0, &actual_dump, &expected_dump);
+
+    ASSERT_SUBSTRING(actual_dump, "32 differing bytes at offsets 000000, 000020, ");
+    ASSERT_SUBSTRING(actual_dump, ", 0001E0, ...\n");
+    ASSERT_SUBSTRING(actual_dump, "\n...  528 bytes not shown");
+}
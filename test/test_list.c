@@ -0,0 +1,224 @@
+#include "narwhal/narwhal.h"
+
+#include "narwhal/utils.h"
+
+TEST_PARAM(meta_list_size, int, { 1, 2, 3 });
+TEST_PARAM(meta_list_mode, int, { 4, 5 });
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_listed_test, meta_list_size, meta_list_mode) {}
+TEST(meta_skipped_test, SKIP) {}
+TEST(meta_timed_sample_test, meta_list_size, meta_list_mode, SAMPLE(20)) {}
+TEST(meta_counted_sample_test, meta_list_size, meta_list_mode, SAMPLE_COUNT(3)) {}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST_GROUP(meta_list_group, { meta_listed_test, meta_skipped_test });
+TEST_GROUP(meta_list_sample_group, { meta_timed_sample_test, meta_counted_sample_test });
+TEST_GROUP(meta_list_other_sample_group, { meta_counted_sample_test });
+
+TEST_PARAM(list_case,
+           struct {
+               NarwhalListFormat format;
+               const char *expected;
+           },
+           { { NARWHAL_LIST_FORMAT_TEXT,
+               "meta_list_group/meta_listed_test[meta_list_size=0,meta_list_mode=0]\n"
+               "meta_list_group/meta_listed_test[meta_list_size=0,meta_list_mode=1]\n"
+               "meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=0]\n"
+               "meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=1]\n"
+               "meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=0]\n"
+               "meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=1]\n" },
+             { NARWHAL_LIST_FORMAT_JSON,
+               "[\n"
+               "  {\"id\": "
+               "\"meta_list_group/meta_listed_test[meta_list_size=0,meta_list_mode=0]\", "
+               "\"name\": \"meta_list_group/meta_listed_test\", \"file\": \"" __FILE__ "\", "
+               "\"line\": 10, \"params\": {\"meta_list_size\": 0, \"meta_list_mode\": 0}},\n"
+               "  {\"id\": "
+               "\"meta_list_group/meta_listed_test[meta_list_size=0,meta_list_mode=1]\", "
+               "\"name\": \"meta_list_group/meta_listed_test\", \"file\": \"" __FILE__ "\", "
+               "\"line\": 10, \"params\": {\"meta_list_size\": 0, \"meta_list_mode\": 1}},\n"
+               "  {\"id\": "
+               "\"meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=0]\", "
+               "\"name\": \"meta_list_group/meta_listed_test\", \"file\": \"" __FILE__ "\", "
+               "\"line\": 10, \"params\": {\"meta_list_size\": 1, \"meta_list_mode\": 0}},\n"
+               "  {\"id\": "
+               "\"meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=1]\", "
+               "\"name\": \"meta_list_group/meta_listed_test\", \"file\": \"" __FILE__ "\", "
+               "\"line\": 10, \"params\": {\"meta_list_size\": 1, \"meta_list_mode\": 1}},\n"
+               "  {\"id\": "
+               "\"meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=0]\", "
+               "\"name\": \"meta_list_group/meta_listed_test\", \"file\": \"" __FILE__ "\", "
+               "\"line\": 10, \"params\": {\"meta_list_size\": 2, \"meta_list_mode\": 0}},\n"
+               "  {\"id\": "
+               "\"meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=1]\", "
+               "\"name\": \"meta_list_group/meta_listed_test\", \"file\": \"" __FILE__ "\", "
+               "\"line\": 10, \"params\": {\"meta_list_size\": 2, \"meta_list_mode\": 1}}\n"
+               "]\n" } });
+
+static void list_group_tests(const NarwhalOptions *options,
+                             NarwhalGroupItemRegistration group_handle,
+                             NarwhalListFormat format,
+                             char **output)
+{
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = options;
+
+    NarwhalTestGroup *root_group =
+        narwhal_new_test_group("root", (NarwhalGroupItemRegistration[]){ group_handle }, 1);
+
+    size_t length = 0;
+
+    FILE *stream = open_memstream(output, &length);
+    narwhal_output_test_list(stream, root_group, format);
+    fclose(stream);
+
+    narwhal_free_test_group(root_group);
+
+    _narwhal_current_options = previous_options;
+}
+
+TEST(list_test_instances, list_case)
+{
+    GET_PARAM(list_case);
+
+    char *output = NULL;
+    list_group_tests(&_narwhal_default_options, meta_list_group, list_case.format, &output);
+    auto_free(output);
+
+    ASSERT_EQ(output, list_case.expected);
+}
+
+TEST(list_selected_param_indices)
+{
+    NarwhalOptions *options = narwhal_new_options();
+    char *argv[] = { "run_tests",
+                     "meta_list_group/meta_listed_test[meta_list_mode=1]",
+                     "meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=0]",
+                     "meta_list_group/meta_listed_test[meta_list_size=5]" };
+    ASSERT(narwhal_parse_options(options, 4, argv));
+
+    char *output = NULL;
+    list_group_tests(options, meta_list_group, NARWHAL_LIST_FORMAT_TEXT, &output);
+    auto_free(output);
+
+    narwhal_free_options(options);
+
+    ASSERT_EQ(output,
+              "meta_list_group/meta_listed_test[meta_list_size=0,meta_list_mode=1]\n"
+              "meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=1]\n"
+              "meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=1]\n"
+              "meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=0]\n");
+}
+
+TEST(list_overlapping_param_indices)
+{
+    NarwhalOptions *options = narwhal_new_options();
+    char *argv[] = { "run_tests",
+                     "meta_list_group/meta_listed_test[meta_list_size=1]",
+                     "meta_list_group/meta_listed_test[meta_list_mode=0]",
+                     "meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=1]",
+                     "meta_list_group/meta_listed_test[meta_list_size=1]" };
+    ASSERT(narwhal_parse_options(options, 5, argv));
+
+    char *output = NULL;
+    list_group_tests(options, meta_list_group, NARWHAL_LIST_FORMAT_TEXT, &output);
+    auto_free(output);
+
+    narwhal_free_options(options);
+
+    ASSERT_EQ(output,
+              "meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=0]\n"
+              "meta_list_group/meta_listed_test[meta_list_size=1,meta_list_mode=1]\n"
+              "meta_list_group/meta_listed_test[meta_list_size=0,meta_list_mode=0]\n"
+              "meta_list_group/meta_listed_test[meta_list_size=2,meta_list_mode=0]\n");
+}
+
+TEST(list_sampled_tests)
+{
+    const NarwhalOptions *options = &_narwhal_default_options;
+
+    char *first = NULL;
+    char *second = NULL;
+    char *json = NULL;
+
+    list_group_tests(options, meta_list_sample_group, NARWHAL_LIST_FORMAT_TEXT, &first);
+    list_group_tests(options, meta_list_sample_group, NARWHAL_LIST_FORMAT_TEXT, &second);
+    list_group_tests(options, meta_list_sample_group, NARWHAL_LIST_FORMAT_JSON, &json);
+
+    auto_free(first);
+    auto_free(second);
+    auto_free(json);
+
+    ASSERT_EQ(first, second);
+    ASSERT_SUBSTRING(first, "meta_list_sample_group/meta_timed_sample_test\n");
+    ASSERT_NOT_SUBSTRING(first, "meta_timed_sample_test[");
+    ASSERT_EQ(narwhal_count_bytes(first, strlen(first), '\n'), (size_t)4);
+    ASSERT_SUBSTRING(json,
+                     "\"id\": \"meta_list_sample_group/meta_timed_sample_test\", "
+                     "\"name\": \"meta_list_sample_group/meta_timed_sample_test\", ");
+    ASSERT_SUBSTRING(json, "\"params\": {}, \"sampled\": true}");
+}
+
+static void strip_test_names(char *output)
+{
+    char *destination = output;
+    bool copying = false;
+
+    for (const char *chr = output; *chr != '\0'; chr++)
+    {
+        copying = *chr == '[' || (copying && *chr != '\n');
+
+        if (copying || *chr == '\n')
+        {
+            *destination++ = *chr;
+        }
+    }
+
+    *destination = '\0';
+}
+
+TEST(list_sampled_tests_per_group)
+{
+    const NarwhalOptions *options = &_narwhal_default_options;
+
+    char *first = NULL;
+    char *second = NULL;
+
+    list_group_tests(options, meta_list_other_sample_group, NARWHAL_LIST_FORMAT_TEXT, &first);
+    list_group_tests(options, meta_list_sample_group, NARWHAL_LIST_FORMAT_TEXT, &second);
+
+    auto_free(first);
+    auto_free(second);
+
+    // Skip the time-boxed test listed before the counted one
+    char *second_counted = strchr(second, '\n') + 1;
+
+    strip_test_names(first);
+    strip_test_names(second_counted);
+
+    ASSERT_EQ(narwhal_count_bytes(first, strlen(first), '['), (size_t)3);
+    ASSERT_NE(first, second_counted);
+}
+
+static void meta_quoted_list_group(NarwhalTestGroup *test_group)
+{
+    static NarwhalGroupItemRegistration group_items[] = { meta_listed_test };
+
+    narwhal_register_subgroup(test_group, "quoted \"group\"\\", group_items, 1);
+}
+
+TEST(list_json_escaped_names)
+{
+    char *output = NULL;
+    list_group_tests(
+        &_narwhal_default_options, meta_quoted_list_group, NARWHAL_LIST_FORMAT_JSON, &output);
+    auto_free(output);
+
+    ASSERT_SUBSTRING(output,
+                     "{\"id\": \"quoted \\\"group\\\"\\\\/meta_listed_test"
+                     "[meta_list_size=0,meta_list_mode=0]\", "
+                     "\"name\": \"quoted \\\"group\\\"\\\\/meta_listed_test\", ");
+}
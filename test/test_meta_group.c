@@ -116,3 +116,122 @@ TEST(run_meta_group, meta_group)
         ASSERT_EQ(status_code, EXIT_SUCCESS);
     }
 }
+
+/*
+ * Lazy materialization
+ */
+
+static size_t meta_registered_tests = 0;
+
+static void count_registration_function(NarwhalTest *test,
+                                        NarwhalCollection *params,
+                                        NarwhalCollection *fixtures,
+                                        void *args)
+{
+    (void)test;
+    (void)params;
+    (void)fixtures;
+    (void)args;
+
+    meta_registered_tests++;
+}
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_lazy_test, { count_registration_function, NULL }) {}
+TEST(meta_lazy_only_test, ONLY, { count_registration_function, NULL }) {}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST_GROUP(meta_lazy_inner_group, { meta_lazy_test, meta_lazy_test });
+TEST_GROUP(meta_lazy_outer_group, { meta_lazy_inner_group, meta_lazy_test });
+TEST_GROUP(meta_lazy_only_group, { meta_lazy_test, meta_lazy_only_test });
+
+TEST(materialize_groups_lazily)
+{
+    meta_registered_tests = 0;
+
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = &_narwhal_default_options;
+
+    NarwhalTestGroup *root_group = narwhal_new_test_group(
+        "root", (NarwhalGroupItemRegistration[]){ meta_lazy_outer_group }, 1);
+
+    _narwhal_current_options = previous_options;
+
+    NarwhalTestGroup *outer_group = root_group->subgroups->first->value;
+
+    ASSERT_EQ(meta_registered_tests, (size_t)0);
+    ASSERT_EQ(root_group->test_count, (size_t)3);
+    ASSERT(!outer_group->materialized);
+
+    narwhal_materialize_test_group(outer_group);
+
+    NarwhalTestGroup *inner_group = outer_group->subgroups->first->value;
+
+    ASSERT_EQ(meta_registered_tests, (size_t)1);
+    ASSERT_EQ(inner_group->test_count, (size_t)2);
+    ASSERT(!inner_group->materialized);
+
+    narwhal_free_test_group(root_group);
+}
+
+static size_t meta_deep_registrations = 0;
+
+static void meta_deep_test_function(void) {}
+
+static void meta_deep_item(NarwhalTestGroup *test_group)
+{
+    meta_deep_registrations++;
+
+    narwhal_register_test(
+        test_group, "meta_deep_test", __FILE__, __LINE__, meta_deep_test_function, NULL, 0, NULL);
+}
+
+TEST_GROUP(meta_deep_inner_group, { meta_deep_item });
+TEST_GROUP(meta_deep_middle_group, { meta_deep_inner_group });
+TEST_GROUP(meta_deep_outer_group, { meta_deep_middle_group });
+
+TEST(materialize_groups_without_rescanning)
+{
+    meta_deep_registrations = 0;
+
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = &_narwhal_default_options;
+
+    NarwhalTestGroup *root_group = narwhal_new_test_group(
+        "root", (NarwhalGroupItemRegistration[]){ meta_deep_outer_group }, 1);
+
+    NarwhalTestGroup *group = root_group;
+
+    while (group->subgroups->count > 0)
+    {
+        group = group->subgroups->first->value;
+        narwhal_materialize_test_group(group);
+    }
+
+    _narwhal_current_options = previous_options;
+
+    size_t test_count = group->tests->count;
+
+    narwhal_free_test_group(root_group);
+
+    ASSERT_EQ(test_count, (size_t)1);
+    ASSERT_EQ(meta_deep_registrations, (size_t)2);
+}
+
+TEST(skip_groups_without_only_tests)
+{
+    meta_registered_tests = 0;
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(test_output)
+    {
+        status_code = RUN_TESTS(meta_lazy_outer_group, meta_lazy_only_group);
+    }
+
+    ASSERT_EQ(status_code, EXIT_SUCCESS);
+    ASSERT_SUBSTRING(test_output, "1 total");
+    ASSERT_EQ(meta_registered_tests, (size_t)2);
+}
@@ -0,0 +1,85 @@
+#include <unistd.h>
+
+#include "narwhal/narwhal.h"
+
+TEST_PARAM(meta_logged_param, int, { 1, 2 });
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_logged_test)
+{
+    printf("logged output\n");
+}
+
+TEST(meta_logged_param_test, meta_logged_param)
+{
+    printf("param output\n");
+}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST(output_log_round_trip)
+{
+    char path[] = "/tmp/narwhal_output_log_XXXXXX";
+    int file = mkstemp(path);
+    ASSERT_NE(file, -1);
+    close(file);
+
+    NarwhalOptions options = _narwhal_default_options;
+    options.output_log = path;
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(session_output)
+    {
+        status_code =
+            RUN_TESTS_WITH_OPTIONS(&options, NULL, meta_logged_test, meta_logged_param_test);
+    }
+
+    bool found_test = false;
+    bool found_params = false;
+    bool found_missing = true;
+
+    CAPTURE_OUTPUT(test_output)
+    {
+        found_test = narwhal_output_log_show(stdout, path, "meta_logged_test");
+    }
+    CAPTURE_OUTPUT(param_output)
+    {
+        found_params = narwhal_output_log_show(stdout, path, "meta_logged_param_test");
+    }
+    CAPTURE_OUTPUT(missing_output)
+    {
+        found_missing = narwhal_output_log_show(stdout, path, "meta_logged");
+    }
+
+    char index_path[sizeof(path) + sizeof(NARWHAL_OUTPUT_LOG_INDEX_SUFFIX)];
+    snprintf(index_path, sizeof(index_path), "%s%s", path, NARWHAL_OUTPUT_LOG_INDEX_SUFFIX);
+    unlink(path);
+    unlink(index_path);
+
+    ASSERT_EQ(status_code, EXIT_SUCCESS);
+    ASSERT(found_test);
+    ASSERT_EQ(test_output, "logged output\n");
+    ASSERT(found_params);
+    ASSERT_EQ(param_output, "param output\nparam output\n");
+    ASSERT(!found_missing);
+}
+
+TEST(output_log_unopenable)
+{
+    NarwhalOptions options = _narwhal_default_options;
+    options.output_log = "/nonexistent/narwhal/output.log";
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(session_output)
+    {
+        status_code = RUN_TESTS_WITH_OPTIONS(&options, NULL, meta_logged_test);
+    }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_SUBSTRING(session_output,
+                     "Couldn't open output log \"/nonexistent/narwhal/output.log\".\n");
+    ASSERT_NOT_SUBSTRING(session_output, "Running tests...");
+}
@@ -0,0 +1,108 @@
+#include <stdint.h>
+
+#include "narwhal/narwhal.h"
+
+TEST_PARAM_FROM_LINES(meta_square_line, "data/squares.txt");
+
+typedef struct
+{
+    uint32_t value;
+    uint32_t square;
+} MetaSquareRecord;
+
+TEST_PARAM_FROM_FILE(meta_square_record, MetaSquareRecord, "data/squares.bin");
+
+TEST_PARAM_FROM_LINES(meta_missing_line, "data/missing.txt");
+
+TEST_PARAM_FROM_FILE(meta_truncated_record, MetaSquareRecord, "data/truncated.bin");
+
+static size_t current_index(const char *param_name)
+{
+    return narwhal_get_test_param(_narwhal_current_params, param_name)->index;
+}
+
+TEST(param_from_lines, meta_square_line)
+{
+    GET_PARAM(meta_square_line);
+
+    size_t index = current_index("meta_square_line");
+
+    char expected[8];
+    snprintf(expected, sizeof(expected), "%zu", index * index);
+
+    ASSERT_EQ(meta_square_line.length, strlen(expected));
+    ASSERT_MEMORY(meta_square_line.data, expected, meta_square_line.length);
+}
+
+TEST(param_from_file_records, meta_square_record)
+{
+    GET_PARAM(meta_square_record);
+
+    size_t index = current_index("meta_square_record");
+
+    ASSERT_EQ((size_t)meta_square_record.value, index);
+    ASSERT_EQ((size_t)meta_square_record.square, index * index);
+}
+
+TEST(param_file_count)
+{
+    NarwhalTest *test = narwhal_new_test(
+        "meta_param_file_test",
+        __FILE__,
+        __LINE__,
+        NULL,
+        (NarwhalTestModifierRegistration[]){ meta_square_line, meta_square_record },
+        2,
+        NULL);
+
+    size_t line_count = narwhal_get_test_param(test->params, "meta_square_line")->count;
+    size_t record_count = narwhal_get_test_param(test->params, "meta_square_record")->count;
+
+    narwhal_free_test(test);
+
+    ASSERT_EQ(line_count, (size_t)6);
+    ASSERT_EQ(record_count, (size_t)8);
+}
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_param_file_missing, meta_missing_line)
+{
+    GET_PARAM(meta_missing_line);
+
+    printf("unreachable %zu\n", meta_missing_line.length);
+}
+
+TEST(meta_param_file_truncated, meta_truncated_record)
+{
+    GET_PARAM(meta_truncated_record);
+
+    printf("unreachable %u\n", meta_truncated_record.value);
+}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST(param_file_missing)
+{
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(output) { status_code = RUN_TESTS(meta_param_file_missing); }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_SUBSTRING(output, "Failed to load test parameter \"meta_missing_line\" from \"");
+    ASSERT_SUBSTRING(output, "/test/data/missing.txt\": No such file or directory.");
+    ASSERT_NOT_SUBSTRING(output, "unreachable");
+}
+
+TEST(param_file_truncated)
+{
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(output) { status_code = RUN_TESTS(meta_param_file_truncated); }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_SUBSTRING(output,
+                     "/test/data/truncated.bin\": The size of the file isn't a multiple of the "
+                     "record size (8 bytes).");
+    ASSERT_NOT_SUBSTRING(output, "unreachable");
+}
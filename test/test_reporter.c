@@ -0,0 +1,112 @@
+#include <string.h>
+
+#include "narwhal/narwhal.h"
+#include "narwhal/utils.h"
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_reported_success)
+{
+}
+
+TEST(meta_reported_failure)
+{
+    printf("failure output\n");
+    ASSERT_EQ(1 + 1, 3);
+}
+
+TEST(meta_reported_control_output)
+{
+    printf("bell\a escape\x1b[0m\tdelete\x7f\r\n");
+    FAIL();
+}
+
+#undef DISABLE_TEST_DISCOVERY
+
+static int run_reporter(const char *reporter,
+                        NarwhalGroupItemRegistration *tests,
+                        size_t test_count)
+{
+    NarwhalOptions options = _narwhal_default_options;
+    options.reporters = narwhal_empty_collection();
+    narwhal_collection_append(options.reporters, narwhal_parse_reporter_config(reporter));
+
+    int status_code = narwhal_run_tests_with_options(&options, NULL, tests, test_count);
+
+    narwhal_free_reporter_config(narwhal_collection_pop(options.reporters));
+    narwhal_free_collection(options.reporters);
+
+    return status_code;
+}
+
+static int run_reported_tests(const char *reporter)
+{
+    return run_reporter(
+        reporter,
+        (NarwhalGroupItemRegistration[]){ meta_reported_success, meta_reported_failure },
+        2);
+}
+
+TEST(reporter_tap)
+{
+    int status_code = -1;
+    CAPTURE_OUTPUT(output) { status_code = run_reported_tests("tap"); }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_SUBSTRING(output, "TAP version 13\nok 1 - meta_reported_success\n");
+    ASSERT_SUBSTRING(output, "not ok 2 - meta_reported_failure\n  ---\n");
+    ASSERT_SUBSTRING(output, "  message: \"Assertion 1 + 1 == 3 failed.\"\n");
+    ASSERT_SUBSTRING(output, "  output: |\n    failure output\n  ...\n1..2\n");
+}
+
+TEST(reporter_tap_control_output)
+{
+    CAPTURE_OUTPUT(output)
+    {
+        run_reporter("tap", (NarwhalGroupItemRegistration[]){ meta_reported_control_output }, 1);
+    }
+
+    ASSERT_SUBSTRING(output,
+                     "  output: |\n    bell\xef\xbf\xbd escape\xef\xbf\xbd[0m\tdelete"
+                     "\xef\xbf\xbd\xef\xbf\xbd\n  ...\n");
+    ASSERT_NOT_SUBSTRING(output, "\x1b[0m\tdelete");
+}
+
+TEST(reporter_json_lines)
+{
+    int status_code = -1;
+    CAPTURE_OUTPUT(output) { status_code = run_reported_tests("jsonl"); }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_EQ(narwhal_count_chars(output, '\n'), (size_t)3);
+    ASSERT_SUBSTRING(output, "{\"event\": \"result\", \"id\": \"meta_reported_success\"");
+    ASSERT_SUBSTRING(output, "\"success\": false");
+    ASSERT_SUBSTRING(output, "\"output\": \"failure output\\n\"");
+    ASSERT_SUBSTRING(output, "{\"event\": \"summary\", \"passed\": 1, \"failed\": 1");
+}
+
+TEST(reporter_junit)
+{
+    int status_code = -1;
+    CAPTURE_OUTPUT(output) { status_code = run_reported_tests("junit"); }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_SUBSTRING(output,
+                     "<testsuite name=\"narwhal\" tests=\"2\" failures=\"1\" errors=\"0\" "
+                     "time=\"");
+    ASSERT_SUBSTRING(output,
+                     "\">\n  <testcase classname=\"test_reporter\" "
+                     "name=\"meta_reported_success\"");
+    ASSERT_SUBSTRING(output, "<failure message=\"Assertion 1 + 1 == 3 failed.\">");
+    ASSERT_SUBSTRING(output, "<system-out>failure output\n</system-out>");
+    ASSERT(strcmp(output + strlen(output) - 13, "</testsuite>\n") == 0);
+}
+
+TEST(reporter_invalid)
+{
+    NarwhalReporterConfig *reporter_config = NULL;
+    CAPTURE_OUTPUT(output) { reporter_config = narwhal_parse_reporter_config("xml:out.xml"); }
+
+    ASSERT(reporter_config == NULL);
+    ASSERT_EQ(output, "Invalid reporter \"xml\", expected text, junit, jsonl or tap.\n");
+}
@@ -0,0 +1,126 @@
+#include "narwhal/narwhal.h"
+
+TEST_PARAM(glob_case,
+           struct {
+               const char *pattern;
+               const char *string;
+               bool partial;
+               bool expected;
+           },
+           { { "foo", "foo", false, true },
+             { "foo", "foobar", false, false },
+             { "foo*", "foobar", false, true },
+             { "*bar", "foo/bar", false, true },
+             { "f?o", "foo", false, true },
+             { "[a-f]oo", "foo", false, true },
+             { "[!a-f]oo", "foo", false, false },
+             { "\\*", "*", false, true },
+             { "group/*", "group/", true, true },
+             { "group/test", "other/", true, false },
+             { "*/test", "any/", true, true } });
+
+TEST(glob_match, glob_case)
+{
+    GET_PARAM(glob_case);
+
+    bool matched = narwhal_glob_match(glob_case.pattern, glob_case.string, glob_case.partial);
+
+    ASSERT_EQ(matched, glob_case.expected);
+}
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_selected_test) {}
+TEST(meta_other_test) {}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST_GROUP(meta_selected_group, { meta_selected_test, meta_other_test });
+TEST_GROUP(meta_other_group, { meta_selected_test, meta_other_test });
+
+TEST_PARAM(selection_case,
+           struct {
+               char *pattern;
+               bool regex;
+               size_t subgroups;
+               size_t tests;
+           },
+           { { "meta_selected_group", false, 1, 2 },
+             { "meta_*_group/meta_selected_test", false, 2, 2 },
+             { "*/meta_selected_test", false, 2, 2 },
+             { "meta_selected_test", false, 0, 0 },
+             { "meta_other_group/meta_other", true, 1, 1 },
+             { "^meta_selected_group", true, 1, 2 } });
+
+TEST(select_tests_while_building_groups, selection_case)
+{
+    GET_PARAM(selection_case);
+
+    NarwhalOptions *options = narwhal_new_options();
+    char *argv[] = { "run_tests", selection_case.regex ? "-E" : "--", selection_case.pattern };
+    ASSERT(narwhal_parse_options(options, 3, argv));
+
+    const NarwhalOptions *previous_options = _narwhal_current_options;
+    _narwhal_current_options = options;
+
+    NarwhalTestGroup *root_group = narwhal_new_test_group(
+        "root", (NarwhalGroupItemRegistration[]){ meta_selected_group, meta_other_group }, 2);
+
+    _narwhal_current_options = previous_options;
+
+    size_t tests = 0;
+
+    NarwhalTestGroup *subgroup;
+    NARWHAL_EACH(subgroup, root_group->subgroups) { tests += subgroup->test_count; }
+
+    size_t subgroups = root_group->subgroups->count;
+
+    narwhal_free_test_group(root_group);
+    narwhal_free_options(options);
+
+    ASSERT_EQ(subgroups, selection_case.subgroups);
+    ASSERT_EQ(tests, selection_case.tests);
+}
+
+TEST(parse_param_selections)
+{
+    NarwhalTestSelector *selector = narwhal_new_test_selector("group/test[size=7,mode=3]", false);
+
+    ASSERT_EQ(selector->pattern, "group/test");
+    ASSERT_EQ(selector->param_selections->count, (size_t)2);
+
+    NarwhalParamSelection *size = selector->param_selections->first->value;
+    NarwhalParamSelection *mode = selector->param_selections->last->value;
+
+    ASSERT_EQ(size->name, "size");
+    ASSERT_EQ(size->index, (size_t)7);
+    ASSERT_EQ(mode->name, "mode");
+    ASSERT_EQ(mode->index, (size_t)3);
+
+    narwhal_free_test_selector(selector);
+
+    selector = narwhal_new_test_selector("group/[ab]*", false);
+
+    ASSERT_EQ(selector->pattern, "group/[ab]*");
+    ASSERT_EQ(selector->param_selections->count, (size_t)0);
+
+    narwhal_free_test_selector(selector);
+
+    CAPTURE_OUTPUT(output) { selector = narwhal_new_test_selector("test[size=]", false); }
+
+    ASSERT(selector == NULL);
+    ASSERT_SUBSTRING(output, "Invalid parameter selection \"[size=]\"");
+}
+
+TEST(parse_param_selection_overflow)
+{
+    NarwhalTestSelector *selector = NULL;
+
+    CAPTURE_OUTPUT(output)
+    {
+        selector = narwhal_new_test_selector("test[size=99999999999999999999999]", false);
+    }
+
+    ASSERT(selector == NULL);
+    ASSERT_SUBSTRING(output, "Invalid parameter selection \"[size=99999999999999999999999]\"");
+}
@@ -0,0 +1,123 @@
+#include <unistd.h>
+
+#include "narwhal/narwhal.h"
+
+TEST_PARAM(meta_streamed_param, int, { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 });
+
+#define DISABLE_TEST_DISCOVERY 1
+
+TEST(meta_streamed_test, meta_streamed_param)
+{
+    GET_PARAM(meta_streamed_param);
+    ASSERT_NE(meta_streamed_param % 4, 0);
+}
+
+TEST(meta_streamed_success) {}
+
+#undef DISABLE_TEST_DISCOVERY
+
+TEST(session_streaming)
+{
+    NarwhalOptions options = _narwhal_default_options;
+    options.streaming = true;
+    options.kept_failures = 3;
+
+    NarwhalTestSession *test_session = narwhal_new_test_session();
+
+    CAPTURE_OUTPUT(session_output)
+    {
+        RUN_TESTS_WITH_OPTIONS(&options, test_session, meta_streamed_test);
+    }
+
+    size_t result_count = test_session->result_count;
+    size_t failure_count = test_session->failure_count;
+    size_t kept_results = test_session->results->count;
+    size_t kept_failures = test_session->failures->count;
+
+    narwhal_free_test_session(test_session);
+
+    ASSERT_EQ(result_count, (size_t)16);
+    ASSERT_EQ(failure_count, (size_t)4);
+    ASSERT_EQ(kept_results, (size_t)3);
+    ASSERT_EQ(kept_failures, (size_t)3);
+    ASSERT_SUBSTRING(session_output, "1 more failing test is not shown.");
+    ASSERT_SUBSTRING(session_output, "4 failed");
+    ASSERT_SUBSTRING(session_output, "12 passed");
+}
+
+TEST(session_streaming_summary_separator)
+{
+    NarwhalOptions options = _narwhal_default_options;
+    options.streaming = true;
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(streamed_output)
+    {
+        status_code = RUN_TESTS_WITH_OPTIONS(&options, NULL, meta_streamed_success);
+    }
+
+    CAPTURE_OUTPUT(kept_output) { RUN_TESTS(meta_streamed_success); }
+
+    ASSERT_EQ(status_code, EXIT_SUCCESS);
+    ASSERT_NOT_SUBSTRING(streamed_output, "Test results:");
+    ASSERT_SUBSTRING(streamed_output, "\n\nTests: ");
+    ASSERT_SUBSTRING(kept_output, "\n\nTests: ");
+}
+
+TEST(session_report_file)
+{
+    char path[] = "/tmp/narwhal_report_XXXXXX";
+    int file = mkstemp(path);
+    ASSERT_NE(file, -1);
+    close(file);
+
+    NarwhalOptions options = _narwhal_default_options;
+    options.report_file = path;
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(session_output)
+    {
+        status_code = RUN_TESTS_WITH_OPTIONS(&options, NULL, meta_streamed_success);
+    }
+
+    char report_buffer[4096] = { 0 };
+    FILE *stream = fopen(path, "r");
+    size_t report_size =
+        stream != NULL ? fread(report_buffer, 1, sizeof(report_buffer) - 1, stream) : 0;
+
+    if (stream != NULL)
+    {
+        fclose(stream);
+    }
+
+    unlink(path);
+
+    const char *report = report_buffer;
+
+    ASSERT_EQ(status_code, EXIT_SUCCESS);
+    ASSERT_EQ(session_output, "");
+    ASSERT_GT(report_size, (size_t)0);
+    ASSERT_SUBSTRING(report, "\nRunning tests...\n");
+    ASSERT_SUBSTRING(report, "PASS");
+    ASSERT_SUBSTRING(report, "meta_streamed_success");
+    ASSERT_SUBSTRING(report, "1 passed");
+}
+
+TEST(session_report_file_unopenable)
+{
+    NarwhalOptions options = _narwhal_default_options;
+    options.report_file = "/nonexistent/narwhal/report.txt";
+
+    int status_code = -1;
+
+    CAPTURE_OUTPUT(session_output)
+    {
+        status_code = RUN_TESTS_WITH_OPTIONS(&options, NULL, meta_streamed_success);
+    }
+
+    ASSERT_EQ(status_code, EXIT_FAILURE);
+    ASSERT_EQ(session_output,
+              "Couldn't open the report file \"/nonexistent/narwhal/report.txt\".\n");
+}